@@ -9,6 +9,25 @@
 #include "full_network.hpp"
 #include "activation_function_benchmark.hpp"
 #include "line_trial.hpp"
+#include "dispatch_benchmark.hpp"
+#include "fast_math_benchmark.hpp"
+#include "static_network_benchmark.hpp"
+#include "optimizer_benchmark.hpp"
+#include "data_parallel_benchmark.hpp"
+#include "hogwild_benchmark.hpp"
+#include "sweep_benchmark.hpp"
+#include "initialisation_benchmark.hpp"
+#include "loss_benchmark.hpp"
+#include "early_stopping_benchmark.hpp"
+#include "online_training_benchmark.hpp"
+#include "importance_sampling_benchmark.hpp"
+#include "dedup_benchmark.hpp"
+#include "growth_benchmark.hpp"
+#include "model_pack_benchmark.hpp"
+#include "normalisation_benchmark.hpp"
+#include "convolution_benchmark.hpp"
+#include "embedding_benchmark.hpp"
+#include "pruning_benchmark.hpp"
 
 namespace tests {
 	/* Prints small message about which tests should be run
@@ -30,6 +49,44 @@ namespace tests {
 	//	runActivationFunctionBenchmark();
 		declareTest("LINE_TRIAL");
 		runLineTrial();
+		declareTest("DISPATCH_BENCHMARK");
+		runDispatchBenchmark();
+		declareTest("FAST_MATH_BENCHMARK");
+		runFastMathBenchmark();
+		declareTest("STATIC_NETWORK_BENCHMARK");
+		runStaticNetworkBenchmark();
+		declareTest("OPTIMIZER_BENCHMARK");
+		runOptimizerBenchmark();
+		declareTest("DATA_PARALLEL_BENCHMARK");
+		runDataParallelBenchmark();
+		declareTest("HOGWILD_BENCHMARK");
+		runHogwildBenchmark();
+		declareTest("SWEEP_BENCHMARK");
+		runSweepBenchmark();
+		declareTest("INITIALISATION_BENCHMARK");
+		runInitialisationBenchmark();
+		declareTest("LOSS_BENCHMARK");
+		runLossBenchmark();
+		declareTest("EARLY_STOPPING_BENCHMARK");
+		runEarlyStoppingBenchmark();
+		declareTest("ONLINE_TRAINING_BENCHMARK");
+		runOnlineTrainingBenchmark();
+		declareTest("IMPORTANCE_SAMPLING_BENCHMARK");
+		runImportanceSamplingBenchmark();
+		declareTest("DEDUP_BENCHMARK");
+		runDedupBenchmark();
+		declareTest("GROWTH_BENCHMARK");
+		runGrowthBenchmark();
+		declareTest("MODEL_PACK_BENCHMARK");
+		runModelPackBenchmark();
+		declareTest("NORMALISATION_BENCHMARK");
+		runNormalisationBenchmark();
+		declareTest("CONVOLUTION_BENCHMARK");
+		runConvolutionBenchmark();
+		declareTest("EMBEDDING_BENCHMARK");
+		runEmbeddingBenchmark();
+		declareTest("PRUNING_BENCHMARK");
+		runPruningBenchmark();
 
 	}
 }
@@ -5,6 +5,7 @@
 
 #include "types.hpp"
 #include <algorithm>
+#include <utility>
 
 namespace alg {
 	// Fill for c-style array of fixed size
@@ -15,9 +16,21 @@ namespace alg {
 
 	// Implementation of copy for array with fixed size
 	template <typename T>
-	void copy(T source[], T destination[], uint length) {
+	void copy(const T source[], T destination[], uint length) {
 		std::copy(source, source + length, destination);
 	}
+
+	// Implementation of unroll, calls f(i) for i in [0, N) at compile time
+	template <uint... I, typename F>
+	void unroll(std::integer_sequence<uint, I...>, F&& f) {
+		(f(I), ...);
+	}
+
+	// Calls f(i) for each i in [0, N), fully unrolled
+	template <uint N, typename F>
+	void unroll(F&& f) {
+		unroll(std::make_integer_sequence<uint, N>(), f);
+	}
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,253 @@
+/* Shapes of layers, and kernels for layers over images
+ * An image is a row of input of (height, width, channels), with channels fastest
+ * A convolution copies each window of its input into a row of columns (im2col)
+ * so it runs through the same fused product and activation kernels as a dense layer
+ */
+#ifndef __CONVOLUTION__
+#define __CONVOLUTION__
+
+#include <assert.h>
+
+#include <algorithm>
+#include <map>
+#include <string>
+
+#include "types.hpp"
+
+// Different kinds of layer
+enum class LayerKinds {
+	// Each node takes all inputs
+	dense = 0,
+	// Filters shared over each window of an image
+	convolution = 1,
+	// Largest value of each channel over each window of an image
+	maxPool = 2,
+	// Sum of a row of weight for each category id of input, as a dense layer over one hot input
+	embedding = 3,
+};
+
+// Map of LayerKinds to string name
+const std::map<LayerKinds, std::string> LAYER_KINDS_TO_NAME = {
+	{LayerKinds::dense, "dense"},
+	{LayerKinds::convolution, "convolution"},
+	{LayerKinds::maxPool, "max pool"},
+	{LayerKinds::embedding, "embedding"}
+};
+
+/* Describes the input and output of a layer
+ * Windows are square, and only taken where they fit inside the image
+ */
+struct LayerShape {
+	LayerKinds kind = LayerKinds::dense;
+
+	// Size of input and number of nodes of a dense layer or embedding
+	uint inputSize = 0;
+	uint nodeCount = 0;
+
+	// Number of categories of an embedding, ids of input are in [0, vocabulary)
+	uint vocabulary = 0;
+
+	// Size of input image
+	uint height = 0;
+	uint width = 0;
+	uint channels = 0;
+
+	// Side of each window, and step between windows
+	uint window = 0;
+	uint stride = 1;
+
+	// Number of filters of a convolution, each is a channel of output
+	uint filters = 0;
+
+	// Dense layer of nodeCount nodes, input size is set by the layer before
+	static LayerShape dense(uint nodeCount) {
+		LayerShape shape;
+		shape.nodeCount = nodeCount;
+		return shape;
+	}
+
+	/* Embedding of slots category ids into nodeCount nodes
+	 * A negative id leaves its slot empty, so examples may have different numbers of categories
+	 * Training on the calling thread only clears and sets gradient of rows of the ids in a batch
+	 * and plain SGD only steps those rows, so a batch costs the ids present rather than the vocabulary
+	 * Optimizers with state still step every row, as their state decays on each step,
+	 * and data parallel and HOGWILD training compute gradient of every row
+	 */
+	static LayerShape embedding(uint slots, uint vocabulary, uint nodeCount) {
+		LayerShape shape;
+		shape.kind = LayerKinds::embedding;
+		shape.inputSize = slots;
+		shape.vocabulary = vocabulary;
+		shape.nodeCount = nodeCount;
+		return shape;
+	}
+
+	// Convolution of filters over each window of an image
+	static LayerShape convolution(uint height, uint width, uint channels, uint window, uint filters, uint stride = 1) {
+		LayerShape shape;
+		shape.kind = LayerKinds::convolution;
+		shape.height = height;
+		shape.width = width;
+		shape.channels = channels;
+		shape.window = window;
+		shape.stride = stride;
+		shape.filters = filters;
+		assert(window && window <= height && window <= width && stride && "Window must fit inside the image");
+		return shape;
+	}
+
+	// Max pooling over windows that do not overlap
+	static LayerShape maxPool(uint height, uint width, uint channels, uint window) {
+		LayerShape shape = convolution(height, width, channels, window, 0, window);
+		shape.kind = LayerKinds::maxPool;
+		return shape;
+	}
+
+	uint getOutputHeight() const {
+		return (height - window) / stride + 1;
+	}
+
+	uint getOutputWidth() const {
+		return (width - window) / stride + 1;
+	}
+
+	// Returns number of windows over the image
+	uint getPositions() const {
+		return getOutputHeight() * getOutputWidth();
+	}
+
+	// Returns channels of output image
+	uint getOutputChannels() const {
+		return kind == LayerKinds::convolution ? filters : channels;
+	}
+
+	// Returns size of a window of input, a row of columns
+	uint getPatchSize() const {
+		return window * window * channels;
+	}
+
+	// Returns true if input is an image
+	bool isImage() const {
+		return kind == LayerKinds::convolution || kind == LayerKinds::maxPool;
+	}
+
+	uint getInputSize() const {
+		return isImage() ? height * width * channels : inputSize;
+	}
+
+	uint getNodeCount() const {
+		return isImage() ? getPositions() * getOutputChannels() : nodeCount;
+	}
+};
+
+namespace kernels {
+	/* Copies each window of each image in input into a row of columns
+	 * input is (batch, inputSize) and columns (batch * positions, patchSize)
+	 * A row of a window is contiguous in both, as channels are fastest
+	 */
+	template <typename T>
+	void im2col(const T* input, uint batch, const LayerShape& shape, T* columns) {
+		const uint inputSize = shape.getInputSize(), patch = shape.getPatchSize();
+		const uint outHeight = shape.getOutputHeight(), outWidth = shape.getOutputWidth();
+		const uint rowLength = shape.window * shape.channels;
+
+		T* out = columns;
+		for (uint j = 0; j < batch; j++) {
+			const T* image = input + (size_t)j * inputSize;
+			for (uint oy = 0; oy < outHeight; oy++) {
+				for (uint ox = 0; ox < outWidth; ox++) {
+					const T* corner = image + ((size_t)oy * shape.stride * shape.width + ox * shape.stride) * shape.channels;
+					for (uint dy = 0; dy < shape.window; dy++) {
+						const T* row = corner + (size_t)dy * shape.width * shape.channels;
+						T* to = out + dy * rowLength;
+						for (uint i = 0; i < rowLength; i++) {
+							to[i] = row[i];
+						}
+					}
+					out += patch;
+				}
+			}
+		}
+	}
+
+	/* Sets dcda of input to the sum of each window in columns over where it was copied from
+	 * Reverse of im2col, dcda is (batch, inputSize)
+	 */
+	template <typename T>
+	void col2im(const T* columns, uint batch, const LayerShape& shape, T* dcda) {
+		const uint inputSize = shape.getInputSize(), patch = shape.getPatchSize();
+		const uint outHeight = shape.getOutputHeight(), outWidth = shape.getOutputWidth();
+		const uint rowLength = shape.window * shape.channels;
+		std::fill(dcda, dcda + (size_t)batch * inputSize, T(0));
+
+		const T* in = columns;
+		for (uint j = 0; j < batch; j++) {
+			T* image = dcda + (size_t)j * inputSize;
+			for (uint oy = 0; oy < outHeight; oy++) {
+				for (uint ox = 0; ox < outWidth; ox++) {
+					T* corner = image + ((size_t)oy * shape.stride * shape.width + ox * shape.stride) * shape.channels;
+					for (uint dy = 0; dy < shape.window; dy++) {
+						T* row = corner + (size_t)dy * shape.width * shape.channels;
+						const T* from = in + dy * rowLength;
+						for (uint i = 0; i < rowLength; i++) {
+							row[i] += from[i];
+						}
+					}
+					in += patch;
+				}
+			}
+		}
+	}
+
+	/* Sets output to the largest value of each channel over each window of input
+	 * If given, index is set to the position in its input row of each largest value
+	 * output and index are (batch, nodeCount)
+	 */
+	template <typename T>
+	void maxPool(const T* input, uint batch, const LayerShape& shape, T* output, T* index) {
+		const uint inputSize = shape.getInputSize(), C = shape.channels;
+		const uint outHeight = shape.getOutputHeight(), outWidth = shape.getOutputWidth();
+
+		for (uint j = 0; j < batch; j++) {
+			const T* image = input + (size_t)j * inputSize;
+			for (uint oy = 0; oy < outHeight; oy++) {
+				for (uint ox = 0; ox < outWidth; ox++) {
+					const uint corner = (oy * shape.stride * shape.width + ox * shape.stride) * C;
+					for (uint c = 0; c < C; c++) {
+						uint best = corner + c;
+						for (uint dy = 0; dy < shape.window; dy++) {
+							for (uint dx = 0; dx < shape.window; dx++) {
+								const uint i = corner + (dy * shape.width + dx) * C + c;
+								best = image[i] > image[best] ? i : best;
+							}
+						}
+						*output++ = image[best];
+						if (index) {
+							*index++ = T(best);
+						}
+					}
+				}
+			}
+		}
+	}
+
+	/* Sets dcda of input from dcda of output of max pooling
+	 * Each output passes its derivative to the input it took, all others are 0
+	 */
+	template <typename T>
+	void maxPoolInput(const T* dcdaOut, const T* index, uint batch, const LayerShape& shape, T* dcda) {
+		const uint inputSize = shape.getInputSize(), nodeCount = shape.getNodeCount();
+		std::fill(dcda, dcda + (size_t)batch * inputSize, T(0));
+
+		for (uint j = 0; j < batch; j++) {
+			T* image = dcda + (size_t)j * inputSize;
+			for (uint o = 0; o < nodeCount; o++) {
+				image[(uint)index[o]] += dcdaOut[o];
+			}
+			dcdaOut += nodeCount;
+			index += nodeCount;
+		}
+	}
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,102 @@
+/* Benchmark of convolution layers
+ * Compares the dense network of the line trial against a convolution with global max pooling
+ * on the same task over larger images, by parameters, training time and accuracy on unseen images */
+#ifndef __CONVOLUTION_BENCHMARK__
+#define __CONVOLUTION_BENCHMARK__
+
+#include <math.h>
+
+#include <iostream>
+
+#include "network.hpp"
+
+namespace tests {
+	// Examples trained on, and unseen examples accuracy is measured on
+	const uint CB_EXAMPLES = 128;
+	const uint CB_TESTS = 256;
+
+	// Length of each diagonal line, as in the line trial
+	const uint CB_LINE = 4;
+
+	// Iteration budget of each run
+	const uint CB_ITERATIONS = 5000;
+
+	/* Generates images of side size, each with a single diagonal line at a random position
+	 * Output is (1, 0) for a line up to the right and (0, 1) for a line down to the right
+	 */
+	void cb_generate(uint size, uint count, uint seed, VMatrix<double>& input, VMatrix<double>& output) {
+		input.qFill(size * size, count, 0.0);
+		output.qFill(2, count, 0.0);
+		rand_ex::seed(seed);
+		for (uint j = 0; j < count; j++) {
+			const uint up = rand_ex::sampleNextIndex(2);
+			const uint x = rand_ex::sampleNextIndex(size - CB_LINE + 1);
+			const uint y = rand_ex::sampleNextIndex(size - CB_LINE + 1);
+			for (uint k = 0; k < CB_LINE; k++) {
+				const uint row = up ? y + CB_LINE - 1 - k : y + k;
+				input.set(row * size + x + k, j, 1.0);
+			}
+			output.set(up ? 0 : 1, j, 1.0);
+		}
+		rand_ex::reset();
+	}
+
+	// Returns fraction of examples where the larger output is the expected one
+	double cb_accuracy(Network<double>& net, const VMatrix<double>& input, const VMatrix<double>& output) {
+		VMatrix<double> prediction = net.makePrediction(input);
+		uint correct = 0;
+		for (uint j = 0; j < input.getColumnLength(); j++) {
+			const bool up = prediction.get(0, j) > prediction.get(1, j);
+			correct += up == (output.get(0, j) > 0.5) ? 1 : 0;
+		}
+		return (double)correct / (double)input.getColumnLength();
+	}
+
+	// Trains a network on the set, and prints parameters, time and accuracy
+	void cb_train(std::string name, Network<double>& net, const VMatrix<double>& input, const VMatrix<double>& output,
+		const VMatrix<double>& testInput, const VMatrix<double>& testOutput) {
+		net.getHParams().set(OPTIMIZER, (double)OptimizerTypes::adam);
+		net.getHParams().set(CONVERGENCE_THRESHOLD, 0.01 * CB_EXAMPLES);
+		net.getHParams().set(ITERATION_MAX, CB_ITERATIONS);
+
+		net.addExample(input, output);
+		net.train();
+
+		std::cout << "  " << name << " " << net.getParameterCount() << " parameters, "
+			<< (net.isConverged() ? "converged" : "failed") << " in " << net.getIterations() << " iterations, "
+			<< net.getExecutionTime() << "s, accuracy " << cb_accuracy(net, input, output) << ", unseen accuracy "
+			<< cb_accuracy(net, testInput, testOutput) << std::endl;
+	}
+
+	/* Compares networks over images of side size
+	 * Dense is the line trial network of 4 hidden nodes
+	 * Convolution has 4 filters of 3 by 3, then max pooling over the whole image
+	 */
+	void cb_compare(uint size) {
+		VMatrix<double> input(1, 1, 0.0), output(1, 1, 0.0), testInput(1, 1, 0.0), testOutput(1, 1, 0.0);
+		cb_generate(size, CB_EXAMPLES, 1, input, output);
+		cb_generate(size, CB_TESTS, 2, testInput, testOutput);
+		std::cout << "Lines in " << size << "x" << size << " images:" << std::endl;
+
+		rand_ex::reset();
+		Network<double> dense(size * size, FunctionTypes::sigmoid, { 4, 2 }, 0.01);
+		cb_train("dense      ", dense, input, output, testInput, testOutput);
+
+		rand_ex::reset();
+		const LayerShape convolution = LayerShape::convolution(size, size, 1, 3, 4);
+		const LayerShape pool = LayerShape::maxPool(size - 2, size - 2, 4, size - 2);
+		Network<double> convolved(size * size, FunctionTypes::sigmoid, { convolution, pool, LayerShape::dense(2) }, 0.01);
+		cb_train("convolution", convolved, input, output, testInput, testOutput);
+	}
+
+	/* Runs all benchmarks
+	 */
+	void runConvolutionBenchmark() {
+		cb_compare(4);
+		cb_compare(8);
+		cb_compare(16);
+		cb_compare(32);
+	}
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,87 @@
+/* Benchmark of data parallel training
+ * Compares time of a fixed number of iterations over thread counts
+ * and checks results are reproducible for a given thread count */
+#ifndef __DATA_PARALLEL_BENCHMARK__
+#define __DATA_PARALLEL_BENCHMARK__
+
+#include <iostream>
+#include <vector>
+
+#include "network.hpp"
+
+namespace tests {
+	// Size of generated training set
+	const uint DPB_EXAMPLES = 4096;
+	const uint DPB_INPUTS = 32;
+
+	// Iterations timed for each thread count
+	const uint DPB_ITERATIONS = 20;
+
+	/* Trains a network on the generated set with given thread count
+	 * from the same initial weights, returns final parameters
+	 */
+	std::vector<double> dpb_train(uint threads, const VMatrix<double>& input, const VMatrix<double>& output, double& time, double& cost) {
+		rand_ex::reset();
+		Network<double> net(DPB_INPUTS, FunctionTypes::tanH, { 64, 32, 1 }, 0.01);
+		net.getHParams().set(THREAD_COUNT, threads);
+		net.getHParams().set(ITERATION_MAX, DPB_ITERATIONS);
+		net.getHParams().set(CONVERGENCE_THRESHOLD, 0.0);
+
+		net.addExample(input, output);
+		net.train();
+
+		time = net.getExecutionTime();
+		cost = net.getCost();
+
+		std::vector<double> parameters(net.getParameterCount());
+		net.getParameters(parameters.data());
+		return parameters;
+	}
+
+	/* Generates the training set
+	 * Output is 1 where sum of input is positive
+	 */
+	void dpb_generate(VMatrix<double>& input, VMatrix<double>& output) {
+		input.qFill(DPB_INPUTS, DPB_EXAMPLES, 0.0);
+		output.qFill(1, DPB_EXAMPLES, 0.0);
+		rand_ex::sampleNextUniforms(input.qGet(), input.getLength(), -1.0, 1.0);
+		for (uint j = 0; j < DPB_EXAMPLES; j++) {
+			double sum = 0.0;
+			for (uint i = 0; i < DPB_INPUTS; i++) {
+				sum += input.get(i, j);
+			}
+			output.set(0, j, sum > 0.0 ? 1.0 : 0.0);
+		}
+	}
+
+	/* Runs all benchmarks
+	 */
+	void runDataParallelBenchmark() {
+		VMatrix<double> input(1, 1, 0.0), output(1, 1, 0.0);
+		dpb_generate(input, output);
+
+		double baseTime = 0.0;
+		std::vector<double> base;
+		for (uint threads : { 1, 2, 3, 4 }) {
+			double time, cost, repeatTime, repeatCost;
+			std::vector<double> a = dpb_train(threads, input, output, time, cost);
+			std::vector<double> b = dpb_train(threads, input, output, repeatTime, repeatCost);
+			if (threads == 1) {
+				baseTime = time;
+				base = a;
+			}
+
+			// Summation order differs from a single thread, so only close to it
+			double difference = 0.0;
+			for (uint i = 0; i < a.size(); i++) {
+				difference = (std::max)(difference, std::abs(a[i] - base[i]));
+			}
+
+			std::cout << threads << " threads: " << time << "s, speedup " << baseTime / time
+				<< ", cost " << cost << ", difference to 1 thread " << difference
+				<< ", " << (a == b ? "REPRODUCIBLE" : "NOT REPRODUCIBLE") << std::endl;
+		}
+	}
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,90 @@
+/* Benchmark of deduplicating examples
+ * Compares full batch training on a set with many repeats stored as added
+ * against the same set stored once per unique example with weights */
+#ifndef __DEDUP_BENCHMARK__
+#define __DEDUP_BENCHMARK__
+
+#include <math.h>
+
+#include <iostream>
+
+#include "line_trial.hpp"
+#include "network.hpp"
+
+namespace tests {
+	// Size of generated set, each of DDB_UNIQUE patterns is repeated DDB_REPEATS times
+	const uint DDB_INPUTS = 8;
+	const uint DDB_UNIQUE = 64;
+	const uint DDB_REPEATS = 64;
+
+	/* Generates a set of repeated patterns in random order
+	 * Input is the bits of a pattern, output is 1 where more than half of the bits are set
+	 */
+	void ddb_generate(VMatrix<double>& input, VMatrix<double>& output) {
+		const uint examples = DDB_UNIQUE * DDB_REPEATS;
+		input.qFill(DDB_INPUTS, examples, 0.0);
+		output.qFill(1, examples, 0.0);
+		rand_ex::seed(5);
+		for (uint j = 0; j < examples; j++) {
+			const uint pattern = rand_ex::sampleNextIndex(DDB_UNIQUE) * 3 + 1;
+			uint bits = 0;
+			for (uint i = 0; i < DDB_INPUTS; i++) {
+				const uint bit = (pattern >> i) & 1;
+				input.set(i, j, (double)bit);
+				bits += bit;
+			}
+			output.set(0, j, bits * 2 > DDB_INPUTS ? 1.0 : 0.0);
+		}
+		rand_ex::reset();
+	}
+
+	/* Trains a network on examples with and without deduplicating, from the same weights
+	 * and prints examples stored, time, cost and largest difference of parameters
+	 */
+	void ddb_compare(std::string name, uint inputWidth, std::vector<uint> nodeCounts, double learningRate,
+		OptimizerTypes optimizer, uint iterations, const VMatrix<double>& input, const VMatrix<double>& output) {
+
+		std::vector<double> parameters[2];
+		std::cout << name << ":" << std::endl;
+		for (uint d = 0; d < 2; d++) {
+			rand_ex::reset();
+			Network<double> net(inputWidth, FunctionTypes::sigmoid, nodeCounts, learningRate);
+			net.getHParams().set(DEDUPLICATE, (double)d);
+			net.getHParams().set(OPTIMIZER, (double)optimizer);
+			net.getHParams().set(CONVERGENCE_THRESHOLD, 0.0);
+			net.getHParams().set(ITERATION_MAX, iterations);
+
+			net.addExample(input, output);
+			net.train();
+
+			parameters[d].resize(net.getParameterCount());
+			net.getParameters(parameters[d].data());
+
+			std::cout << "  " << (d ? "deduplicated" : "as added    ") << " " << net.getExampleCount() << " stored of "
+				<< net.getExampleWeight() << ", " << net.getExecutionTime() << "s, cost " << net.getCost() << std::endl;
+		}
+
+		double difference = 0.0;
+		for (uint i = 0; i < parameters[0].size(); i++) {
+			difference = (std::max)(difference, fabs(parameters[0][i] - parameters[1][i]));
+		}
+		std::cout << "  largest difference of parameters " << difference << std::endl;
+	}
+
+	/* Runs all benchmarks
+	 */
+	void runDedupBenchmark() {
+		// Line trial repeats some of its examples
+		LineTrialMaster master = lt_getMaster();
+		ddb_compare("Line trial", 16, { 4, 2 }, 1.0, OptimizerTypes::SGD, 2000, master.getInput(16), master.getOutput(2));
+
+		VMatrix<double> input(1, 1, 0.0), output(1, 1, 0.0);
+		ddb_generate(input, output);
+		ddb_compare("Generated " + std::to_string(DDB_UNIQUE * DDB_REPEATS) + ", SGD", DDB_INPUTS, { 8, 1 }, 1.0,
+			OptimizerTypes::SGD, 2000, input, output);
+		ddb_compare("Generated " + std::to_string(DDB_UNIQUE * DDB_REPEATS) + ", L-BFGS", DDB_INPUTS, { 8, 1 }, 1.0,
+			OptimizerTypes::LBFGS, 200, input, output);
+	}
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,86 @@
+/* Benchmark of activation dispatch
+ * Compares calling activation through a function pointer per element
+ * against kernels templated on an activation policy */
+#ifndef __DISPATCH_BENCHMARK__
+#define __DISPATCH_BENCHMARK__
+
+#include <atomic>
+#include <iostream>
+#include <vector>
+
+#include "alg.hpp"
+#include "layer_kernels.hpp"
+#include "rand_ex.hpp"
+#include "stopwatch.hpp"
+
+namespace tests {
+	// Number of elements in each benchmark array
+	const uint DB_LENGTH = 1 << 16;
+
+	// Number of passes over benchmark array
+	const uint DB_REPEATS = 200;
+
+	/* Applies activation and derivative through function pointers
+	 * as was done by each node per element
+	 * Pointers are to the functions of the policy, so both paths compute the same formulas
+	 */
+	template <typename Act>
+	double db_pointerDispatch(std::vector<double>& z, std::vector<double>& a, std::vector<double>& dadz) {
+		// volatile to stop the compiler from resolving the pointer
+		double(* volatile function)(double) = &Act::template function<double>;
+		double(* volatile derivative)(double, double) = &Act::template derivative<double>;
+
+		stopwatch::tic();
+		for (uint r = 0; r < DB_REPEATS; r++) {
+			double(*f)(double) = function;
+			double(*d)(double, double) = derivative;
+			for (uint i = 0; i < DB_LENGTH; i++) {
+				a[i] = f(z[i]);
+				dadz[i] = d(z[i], a[i]);
+			}
+			// Stops repeats from being merged
+			std::atomic_signal_fence(std::memory_order_seq_cst);
+		}
+		return stopwatch::tocGet();
+	}
+
+	/* Applies activation and derivative with a kernel templated on policy
+	 */
+	template <typename Act>
+	double db_staticDispatch(std::vector<double>& z, std::vector<double>& a, std::vector<double>& dadz) {
+		stopwatch::tic();
+		for (uint r = 0; r < DB_REPEATS; r++) {
+			alg::copy(z.data(), a.data(), DB_LENGTH);
+			kernels::activate<double, Act>(a.data(), dadz.data(), DB_LENGTH);
+			std::atomic_signal_fence(std::memory_order_seq_cst);
+		}
+		return stopwatch::tocGet();
+	}
+
+	// Benchmarks a single activation policy, and prints result
+	template <typename Act>
+	void db_compare() {
+		std::vector<double> z(DB_LENGTH), a(DB_LENGTH), dadz(DB_LENGTH);
+		rand_ex::sampleNextUniforms(z.data(), DB_LENGTH, -4.0, 4.0);
+
+		double pointer = db_pointerDispatch<Act>(z, a, dadz);
+		double check = a[DB_LENGTH / 2];
+		double fixed = db_staticDispatch<Act>(z, a, dadz);
+
+		std::cout << Functions<double>::getFunctionName(Act::TYPE) << ": "
+			<< "pointer " << pointer << "s, static " << fixed << "s, speedup " << pointer / fixed
+			<< (check == a[DB_LENGTH / 2] ? "" : " (MISMATCH)") << std::endl;
+	}
+
+	/* Runs all benchmarks
+	 */
+	void runDispatchBenchmark() {
+		db_compare<activation::Sigmoid>();
+		db_compare<activation::ReLU>();
+		db_compare<activation::LeakyReLU>();
+		db_compare<activation::Softplus>();
+		db_compare<activation::TanH>();
+	}
+}
+
+#endif
\ No newline at end of file
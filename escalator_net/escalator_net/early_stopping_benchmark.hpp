@@ -0,0 +1,110 @@
+/* Benchmark of early stopping
+ * Compares iterations and held out cost of runs with and without
+ * patience, plateau and divergence detection */
+#ifndef __EARLY_STOPPING_BENCHMARK__
+#define __EARLY_STOPPING_BENCHMARK__
+
+#include <math.h>
+
+#include <iostream>
+
+#include "network.hpp"
+
+namespace tests {
+	// Size of generated noisy set
+	const uint ESB_EXAMPLES = 32;
+
+	// Iteration budget of each run
+	const uint ESB_ITERATIONS = 20000;
+
+	/* Generates a small noisy regression set, easy to overfit
+	 * Output is sin(3x) with uniform noise
+	 */
+	void esb_generate(VMatrix<double>& input, VMatrix<double>& output) {
+		input.qFill(1, ESB_EXAMPLES, 0.0);
+		output.qFill(1, ESB_EXAMPLES, 0.0);
+		rand_ex::seed(2);
+		rand_ex::sampleNextUniforms(input.qGet(), ESB_EXAMPLES, -1.0, 1.0);
+		rand_ex::sampleNextUniforms(output.qGet(), ESB_EXAMPLES, -0.3, 0.3);
+		rand_ex::reset();
+		for (uint j = 0; j < ESB_EXAMPLES; j++) {
+			output.set(0, j, output.get(0, j) + sin(3.0 * input.get(0, j)));
+		}
+	}
+
+	/* Trains a network with given hyper parameters on the set
+	 * and prints why it stopped, iterations and cost
+	 */
+	void esb_train(std::string name, FunctionTypes type, OptimizerTypes optimizer, double learningRate, uint patience, uint plateau,
+		const VMatrix<double>& input, const VMatrix<double>& output) {
+
+		rand_ex::reset();
+		Network<double> net(1, type, { 64, 1 }, learningRate);
+		net.initialise(InitialisationTypes::automatic);
+		net.getHParams().set(OPTIMIZER, (double)optimizer);
+		net.getHParams().set(ITERATION_MAX, ESB_ITERATIONS);
+		net.getHParams().set(CONVERGENCE_THRESHOLD, 0.0);
+		net.getHParams().set(VALIDATION_SPLIT, 0.25);
+		net.getHParams().set(PATIENCE, patience);
+		net.getHParams().set(PLATEAU, plateau);
+
+		net.addExample(input, output);
+		net.train();
+
+		std::cout << "  " << name << ": " << STOP_REASONS_TO_NAME.at(net.getStopReason())
+			<< " after " << net.getIterations() << " iterations, " << net.getExecutionTime()
+			<< "s, cost " << net.getCost() << ", validation cost " << net.getValidationCost() << std::endl;
+	}
+
+	/* Trains a network with a zero learning rate several times on the set
+	 * Parameters never change, so validation cost only changes if held out examples do
+	 */
+	void esb_repeatSplit(const VMatrix<double>& input, const VMatrix<double>& output) {
+		const uint RUNS = 4;
+
+		rand_ex::reset();
+		Network<double> net(1, FunctionTypes::tanH, { 16, 1 }, 0.0);
+		net.initialise(InitialisationTypes::automatic);
+		net.getHParams().set(OPTIMIZER, (double)OptimizerTypes::SGD);
+		net.getHParams().set(ITERATION_MAX, 4);
+		net.getHParams().set(CONVERGENCE_THRESHOLD, 0.0);
+		net.getHParams().set(VALIDATION_SPLIT, 0.25);
+		net.getHParams().set(BATCH_SIZE, 8);
+		net.addExample(input, output);
+
+		double first = 0.0, largest = 0.0;
+		for (uint i = 0; i < RUNS; i++) {
+			net.train();
+			if (!i) {
+				first = net.getValidationCost();
+			}
+			largest = (std::max)(largest, fabs(net.getValidationCost() - first));
+		}
+
+		std::cout << "  " << RUNS << " trainings, validation cost " << first
+			<< ", largest difference " << largest << std::endl;
+	}
+
+	/* Runs all benchmarks
+	 */
+	void runEarlyStoppingBenchmark() {
+		VMatrix<double> input(1, 1, 0.0), output(1, 1, 0.0);
+		esb_generate(input, output);
+
+		std::cout << "Overfitting tanh:" << std::endl;
+		esb_train("no patience", FunctionTypes::tanH, OptimizerTypes::adam, 0.02, 0, 0, input, output);
+		esb_train("patience 500", FunctionTypes::tanH, OptimizerTypes::adam, 0.02, 500, 0, input, output);
+
+		std::cout << "Stuck softplus:" << std::endl;
+		esb_train("no plateau", FunctionTypes::softplus, OptimizerTypes::SGD, 300.0, 0, 0, input, output);
+		esb_train("plateau 500", FunctionTypes::softplus, OptimizerTypes::SGD, 300.0, 0, 500, input, output);
+
+		std::cout << "Diverging softplus:" << std::endl;
+		esb_train("learning rate 10000", FunctionTypes::softplus, OptimizerTypes::SGD, 10000.0, 0, 0, input, output);
+
+		std::cout << "Training again keeps held out examples:" << std::endl;
+		esb_repeatSplit(input, output);
+	}
+}
+
+#endif
\ No newline at end of file
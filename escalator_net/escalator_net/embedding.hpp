@@ -0,0 +1,150 @@
+/* Kernels of embedding layers
+ * Input is a row of category ids for each example, stored as T, with a negative id for an empty slot
+ * Each id selects a row of weight, as a 1 in one hot input would
+ * so work is over the ids present rather than the whole vocabulary
+ */
+#ifndef __EMBEDDING__
+#define __EMBEDDING__
+
+#include <assert.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "types.hpp"
+
+namespace kernels {
+	// Returns true if each of length ids is negative, or a whole number below vocabulary
+	template <typename T>
+	bool validIds(const T* ids, size_t length, uint vocabulary) {
+		for (size_t i = 0; i < length; i++) {
+			if (!(ids[i] < T(0)) && !(ids[i] < T(vocabulary) && ids[i] == T((uint)ids[i]))) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	/* Computes z = b plus the row of weight of each id, the same as XW + b for one hot X
+	 * ids is (batch, slots), weight is (vocabulary, nodeCount), bias is (1, nodeCount) and z is (batch, nodeCount)
+	 */
+	template <typename T>
+	void embed(const T* ids, uint batch, uint slots, const T* weight, const T* bias, uint vocabulary, uint nodeCount, T* z) {
+		for (uint j = 0; j < batch; j++) {
+			T* row = z + (size_t)j * nodeCount;
+			const T* x = ids + (size_t)j * slots;
+
+			for (uint n = 0; n < nodeCount; n++) {
+				row[n] = bias[n];
+			}
+
+			for (uint s = 0; s < slots; s++) {
+				if (x[s] < T(0)) {
+					continue;
+				}
+				const uint id = (uint)x[s];
+				assert(id < vocabulary && "Category id must be inside the vocabulary");
+
+				const T* w = weight + (size_t)id * nodeCount;
+				for (uint n = 0; n < nodeCount; n++) {
+					row[n] += w[n];
+				}
+			}
+		}
+	}
+
+	/* Computes gradient of an embedding, delta is dC/dz (batch, nodeCount)
+	 * Each row of delta is added to the rows of dWeight of its ids, others stay 0
+	 * scale is applied to the sum over the batch
+	 */
+	template <typename T>
+	void embedGradient(const T* ids, const T* delta, uint batch, uint slots, uint vocabulary, uint nodeCount, T scale,
+		T* dWeight, T* dBias) {
+
+		const size_t length = (size_t)vocabulary * nodeCount;
+		std::fill(dWeight, dWeight + length, T(0));
+		std::fill(dBias, dBias + nodeCount, T(0));
+
+		for (uint j = 0; j < batch; j++) {
+			const T* x = ids + (size_t)j * slots;
+			const T* d = delta + (size_t)j * nodeCount;
+
+			for (uint s = 0; s < slots; s++) {
+				if (x[s] < T(0)) {
+					continue;
+				}
+				const uint id = (uint)x[s];
+				assert(id < vocabulary && "Category id must be inside the vocabulary");
+
+				T* w = dWeight + (size_t)id * nodeCount;
+				for (uint n = 0; n < nodeCount; n++) {
+					w[n] += d[n];
+				}
+			}
+
+			for (uint n = 0; n < nodeCount; n++) {
+				dBias[n] += d[n];
+			}
+		}
+
+		for (size_t i = 0; i < length; i++) {
+			dWeight[i] *= scale;
+		}
+		for (uint n = 0; n < nodeCount; n++) {
+			dBias[n] *= scale;
+		}
+	}
+
+	/* Computes gradient of an embedding as embedGradient, over only the rows of ids in the batch
+	 * rows lists the rows of dWeight that may be non zero, which are cleared, and is set to the rows of this batch
+	 * so cost scales with the ids present rather than the vocabulary
+	 */
+	template <typename T>
+	void embedGradientRows(const T* ids, const T* delta, uint batch, uint slots, uint vocabulary, uint nodeCount, T scale,
+		T* dWeight, T* dBias, std::vector<uint>& rows) {
+
+		for (uint r : rows) {
+			std::fill(dWeight + (size_t)r * nodeCount, dWeight + (size_t)(r + 1) * nodeCount, T(0));
+		}
+		std::fill(dBias, dBias + nodeCount, T(0));
+
+		rows.clear();
+		for (uint j = 0; j < batch; j++) {
+			const T* x = ids + (size_t)j * slots;
+			const T* d = delta + (size_t)j * nodeCount;
+
+			for (uint s = 0; s < slots; s++) {
+				if (x[s] < T(0)) {
+					continue;
+				}
+				const uint id = (uint)x[s];
+				assert(id < vocabulary && "Category id must be inside the vocabulary");
+				rows.push_back(id);
+
+				T* w = dWeight + (size_t)id * nodeCount;
+				for (uint n = 0; n < nodeCount; n++) {
+					w[n] += d[n];
+				}
+			}
+
+			for (uint n = 0; n < nodeCount; n++) {
+				dBias[n] += d[n];
+			}
+		}
+
+		// Each row is scaled once, however many times its id appeared
+		std::sort(rows.begin(), rows.end());
+		rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+		for (uint r : rows) {
+			T* w = dWeight + (size_t)r * nodeCount;
+			for (uint n = 0; n < nodeCount; n++) {
+				w[n] *= scale;
+			}
+		}
+		for (uint n = 0; n < nodeCount; n++) {
+			dBias[n] *= scale;
+		}
+	}
+}
+
+#endif
\ No newline at end of file
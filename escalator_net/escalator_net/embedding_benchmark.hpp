@@ -0,0 +1,182 @@
+/* Benchmark of embedding layers
+ * Compares a dense first layer over one hot categorical input against
+ * an embedding of the same category ids, from the same weights */
+#ifndef __EMBEDDING_BENCHMARK__
+#define __EMBEDDING_BENCHMARK__
+
+#include <math.h>
+
+#include <iostream>
+
+#include "network.hpp"
+
+namespace tests {
+	// Categorical features of each example, and categories of each feature
+	const uint EB_FEATURES = 8;
+	const uint EB_CATEGORIES = 512;
+	const uint EB_VOCABULARY = EB_FEATURES * EB_CATEGORIES;
+	const uint EB_EXAMPLES = 1024;
+
+	/* Generates examples with a category of each feature, as ids and as one hot input
+	 * Id of a category is offset by its feature, so all share a single vocabulary
+	 * Each category has a random score, and output is 1 where the sum of scores is above 0
+	 */
+	void eb_generate(VMatrix<double>& ids, VMatrix<double>& oneHot, VMatrix<double>& output) {
+		ids.qFill(EB_FEATURES, EB_EXAMPLES, 0.0);
+		oneHot.qFill(EB_VOCABULARY, EB_EXAMPLES, 0.0);
+		output.qFill(1, EB_EXAMPLES, 0.0);
+		rand_ex::seed(8);
+
+		std::vector<double> scores(EB_VOCABULARY);
+		rand_ex::sampleNextUniforms(scores.data(), EB_VOCABULARY, -1.0, 1.0);
+		for (uint j = 0; j < EB_EXAMPLES; j++) {
+			double sum = 0.0;
+			for (uint f = 0; f < EB_FEATURES; f++) {
+				const uint id = f * EB_CATEGORIES + rand_ex::sampleNextIndex(EB_CATEGORIES);
+				ids.set(f, j, (double)id);
+				oneHot.set(id, j, 1.0);
+				sum += scores[id];
+			}
+			output.set(0, j, sum > 0.0 ? 1.0 : 0.0);
+		}
+		rand_ex::reset();
+	}
+
+	/* Trains a dense network on one hot input, and an embedding network on ids, from the same weights
+	 * and prints time, bytes of input, cost, time per prediction and largest difference of parameters
+	 */
+	void eb_compare(std::string name, uint batchSize, uint iterations,
+		const VMatrix<double>& ids, const VMatrix<double>& oneHot, const VMatrix<double>& output) {
+
+		std::vector<double> parameters[2];
+		std::cout << name << ":" << std::endl;
+		for (uint e = 0; e < 2; e++) {
+			const VMatrix<double>& input = e ? ids : oneHot;
+
+			rand_ex::reset();
+			Network<double> net = e
+				? Network<double>(EB_FEATURES, FunctionTypes::sigmoid,
+					{ LayerShape::embedding(EB_FEATURES, EB_VOCABULARY, 16), LayerShape::dense(1) }, 1.0)
+				: Network<double>(EB_VOCABULARY, FunctionTypes::sigmoid, { 16, 1 }, 1.0);
+			net.getHParams().set(BATCH_SIZE, batchSize);
+			net.getHParams().set(SHUFFLE, 0.0);
+			net.getHParams().set(CONVERGENCE_THRESHOLD, 0.0);
+			net.getHParams().set(ITERATION_MAX, iterations);
+
+			net.addExample(input, output);
+			net.train();
+
+			stopwatch::tic();
+			net.makePrediction(input);
+			const double predictionTime = stopwatch::tocGet() / EB_EXAMPLES;
+
+			parameters[e].resize(net.getParameterCount());
+			net.getParameters(parameters[e].data());
+
+			std::cout << "  " << (e ? "embedding" : "one hot  ") << " " << net.getExecutionTime() << "s, "
+				<< input.getLength() * sizeof(double) << " bytes of input, cost " << net.getCost() << ", "
+				<< predictionTime * 1e9 << "ns per prediction" << std::endl;
+		}
+
+		double difference = 0.0;
+		for (uint i = 0; i < parameters[0].size(); i++) {
+			difference = (std::max)(difference, fabs(parameters[0][i] - parameters[1][i]));
+		}
+		std::cout << "  largest difference of parameters " << difference << std::endl;
+	}
+
+	/* Initialises an embedding with He, and prints the largest weight against its range
+	 * Only one row of each slot is summed per example, so range is set by slots rather than vocabulary
+	 */
+	void eb_initialisation() {
+		rand_ex::reset();
+		Network<double> net(EB_FEATURES, FunctionTypes::ReLU,
+			{ LayerShape::embedding(EB_FEATURES, EB_VOCABULARY, 16), LayerShape::dense(1) }, 1.0);
+		net.initialise(InitialisationTypes::he);
+
+		std::vector<double> parameters(net.getParameterCount());
+		net.getParameters(parameters.data());
+		double largest = 0.0;
+		for (uint i = 0; i < EB_VOCABULARY * 16; i++) {
+			largest = (std::max)(largest, fabs(parameters[i]));
+		}
+
+		std::cout << "He initialisation of embedding: range " << sqrt(6.0 / EB_FEATURES)
+			<< ", largest weight " << largest << std::endl;
+	}
+
+	/* Trains an embedding over a large vocabulary in small batches with SGD, which only steps rows of ids present
+	 * against momentum with no decay, which takes the same steps over every row
+	 * and prints time and largest difference of parameters
+	 */
+	void eb_rows() {
+		const uint SLOTS = 8, VOCABULARY = 1 << 17, EXAMPLES = 4096, BATCH = 64;
+
+		VMatrix<double> ids(SLOTS, EXAMPLES, 0.0), output(1, EXAMPLES, 0.0);
+		rand_ex::seed(9);
+		for (uint j = 0; j < EXAMPLES; j++) {
+			for (uint s = 0; s < SLOTS; s++) {
+				ids.set(s, j, (double)rand_ex::sampleNextIndex(VOCABULARY));
+			}
+			output.set(0, j, (double)rand_ex::sampleNextIndex(2));
+		}
+
+		std::vector<double> parameters[2];
+		std::cout << SLOTS << " ids of " << VOCABULARY << " in batches of " << BATCH << ":" << std::endl;
+		for (uint m = 0; m < 2; m++) {
+			rand_ex::reset();
+			Network<double> net(SLOTS, FunctionTypes::sigmoid,
+				{ LayerShape::embedding(SLOTS, VOCABULARY, 16), LayerShape::dense(1) }, 0.5);
+			net.getHParams().set(OPTIMIZER, (double)(m ? OptimizerTypes::momentum : OptimizerTypes::SGD));
+			net.getHParams().set(BETA1, 0.0);
+			net.getHParams().set(BATCH_SIZE, BATCH);
+			net.getHParams().set(SHUFFLE, 0.0);
+			net.getHParams().set(CONVERGENCE_THRESHOLD, 0.0);
+			net.getHParams().set(ITERATION_MAX, EXAMPLES / BATCH);
+
+			net.addExample(ids, output);
+			net.train();
+
+			parameters[m].resize(net.getParameterCount());
+			net.getParameters(parameters[m].data());
+			std::cout << "  " << (m ? "every row" : "rows used") << " " << net.getExecutionTime() << "s, cost " << net.getCost() << std::endl;
+		}
+
+		double difference = 0.0;
+		for (uint i = 0; i < parameters[0].size(); i++) {
+			difference = (std::max)(difference, fabs(parameters[0][i] - parameters[1][i]));
+		}
+		std::cout << "  largest difference of parameters " << difference << std::endl;
+	}
+
+	/* Checks which ids an embedding accepts as input
+	 * Ids outside the vocabulary would read and write outside its weight
+	 */
+	void eb_validation() {
+		Network<double> net(2, FunctionTypes::sigmoid, { LayerShape::embedding(2, 4, 2), LayerShape::dense(1) }, 1.0);
+		const std::vector<std::vector<double>> inputs = { { 0.0, 3.0 }, { -1.0, 2.0 }, { 4.0, 0.0 }, { 1.5, 0.0 }, { NAN, 0.0 } };
+
+		std::cout << "Ids accepted by an embedding of 4:";
+		for (auto& i : inputs) {
+			const VMatrix<double> input({ i });
+			std::cout << " (" << i[0] << ", " << i[1] << ") " << (net.isValidInput(input) ? "yes" : "no");
+		}
+		std::cout << std::endl;
+	}
+
+	/* Runs all benchmarks
+	 */
+	void runEmbeddingBenchmark() {
+		VMatrix<double> ids(1, 1, 0.0), oneHot(1, 1, 0.0), output(1, 1, 0.0);
+		eb_generate(ids, oneHot, output);
+
+		const std::string name = std::to_string(EB_FEATURES) + " features of " + std::to_string(EB_CATEGORIES) + " categories";
+		eb_compare(name + ", full batch", 0, 20, ids, oneHot, output);
+		eb_compare(name + ", batches of 64", 64, 64, ids, oneHot, output);
+		eb_rows();
+		eb_initialisation();
+		eb_validation();
+	}
+}
+
+#endif
\ No newline at end of file
@@ -5,8 +5,61 @@ class FunctionTypes(Enum) :
     ReLU = "ReLU"
     LeakyReLU = "LeakyReLU"
     softplus = "softplus"
+    tanh = "tanh"
+    linear = "linear"
+
+class InitialisationTypes(Enum) :
+    uniform = "uniform"
+    automatic = "automatic"
+    xavier = "xavier"
+    he = "he"
+    lecun = "lecun"
+
+class LossTypes(Enum) :
+    squared_error = 0
+    sigmoid_cross_entropy = 1
+    softmax_cross_entropy = 2
+
+class NormalisationTypes(Enum) :
+    none = 0
+    standard = 1
+    range = 2
+
+class OptimizerTypes(Enum) :
+    SGD = 0
+    momentum = 1
+    nesterov = 2
+    RMSProp = 3
+    adam = 4
+    LBFGS = 5
 
 class Parameters(Enum) :
     convergence_threshold = "convergence_threshold"
     iteration_max = "iteration_max"
-    learning_rate = "learning_rate"
\ No newline at end of file
+    learning_rate = "learning_rate"
+    fast_math = "fast_math"
+    cost_interval = "cost_interval"
+    batch_size = "batch_size"
+    shuffle = "shuffle"
+    optimizer = "optimizer"
+    beta1 = "beta1"
+    beta2 = "beta2"
+    epsilon = "epsilon"
+    lbfgs_history = "lbfgs_history"
+    lbfgs_max_step = "lbfgs_max_step"
+    lbfgs_restarts = "lbfgs_restarts"
+    lbfgs_stall = "lbfgs_stall"
+    threads = "threads"
+    hogwild = "hogwild"
+    loss = "loss"
+    validation_split = "validation_split"
+    patience = "patience"
+    plateau = "plateau"
+    plateau_tolerance = "plateau_tolerance"
+    sampling = "sampling"
+    refresh_interval = "refresh_interval"
+    deduplicate = "deduplicate"
+    grow_limit = "grow_limit"
+    grow_width = "grow_width"
+    grow_depth = "grow_depth"
+    normalise = "normalise"
\ No newline at end of file
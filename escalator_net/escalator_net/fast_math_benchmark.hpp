@@ -0,0 +1,163 @@
+/* Benchmark of fast_math against libm
+ * Reports worst case error in ULP and speed up for each function */
+#ifndef __FAST_MATH_BENCHMARK__
+#define __FAST_MATH_BENCHMARK__
+
+#include <math.h>
+
+#include <atomic>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+#include "fast_math.hpp"
+#include "network.hpp"
+#include "stopwatch.hpp"
+
+namespace tests {
+	// Number of points sampled for each function
+	const uint FMB_LENGTH = 1 << 16;
+
+	// Number of passes for timing
+	const uint FMB_REPEATS = 100;
+
+	// Error of approximation in units of last place of exact
+	template <typename T>
+	double fmb_ulp(T approximation, T exact) {
+		T ulp = nextafter(std::abs(exact), std::numeric_limits<T>::infinity()) - std::abs(exact);
+		return std::abs((double)approximation - (double)exact) / (double)ulp;
+	}
+
+	/* Compares fast function F against exact function E over [lower, upper]
+	 */
+	template <typename T, typename F, typename E>
+	void fmb_compare(std::string name, F fast, E exact, T lower, T upper) {
+		std::vector<T> x(FMB_LENGTH), a(FMB_LENGTH), b(FMB_LENGTH);
+		for (uint i = 0; i < FMB_LENGTH; i++) {
+			x[i] = lower + (upper - lower) * T(i) / T(FMB_LENGTH - 1);
+		}
+
+		stopwatch::tic();
+		for (uint r = 0; r < FMB_REPEATS; r++) {
+			for (uint i = 0; i < FMB_LENGTH; i++) {
+				a[i] = exact(x[i]);
+			}
+			// Stops repeats from being merged
+			std::atomic_signal_fence(std::memory_order_seq_cst);
+		}
+		double exactTime = stopwatch::tocGet();
+
+		stopwatch::tic();
+		for (uint r = 0; r < FMB_REPEATS; r++) {
+			for (uint i = 0; i < FMB_LENGTH; i++) {
+				b[i] = fast(x[i]);
+			}
+			std::atomic_signal_fence(std::memory_order_seq_cst);
+		}
+		double fastTime = stopwatch::tocGet();
+
+		double worst = 0.0;
+		for (uint i = 0; i < FMB_LENGTH; i++) {
+			worst = (std::max)(worst, fmb_ulp(b[i], a[i]));
+		}
+
+		std::cout << name << (sizeof(T) == sizeof(double) ? " double" : " float")
+			<< ": max error " << worst << " ULP, speedup " << exactTime / fastTime << std::endl;
+	}
+
+	// Compares all functions for type T
+	template <typename T>
+	void fmb_compareAll() {
+		fmb_compare<T>("exp",
+			[](T x) { return fast_math::exp(x); }, [](T x) { return (T)exp(x); }, T(-40), T(40));
+		fmb_compare<T>("expm1",
+			[](T x) { return fast_math::expm1(x); }, [](T x) { return (T)expm1(x); }, T(-40), T(40));
+		fmb_compare<T>("log1p",
+			[](T x) { return fast_math::log1p(x); }, [](T x) { return (T)log1p(x); }, T(-0.99), T(40));
+		fmb_compare<T>("sigmoid",
+			[](T x) { return fast_math::sigmoid(x); }, [](T x) { return activation::Sigmoid::function(x); }, T(-40), T(40));
+		fmb_compare<T>("softplus",
+			[](T x) { return fast_math::softplus(x); }, [](T x) { return (T)log1p(exp(x)); }, T(-40), T(40));
+		fmb_compare<T>("tanh",
+			[](T x) { return fast_math::tanh(x); }, [](T x) { return (T)tanh(x); }, T(-40), T(40));
+	}
+
+	/* Times the training activation kernel for an exact and fast policy
+	 */
+	template <typename Exact, typename Fast>
+	void fmb_kernel() {
+		std::vector<double> x(FMB_LENGTH), a(FMB_LENGTH), dadz(FMB_LENGTH);
+		rand_ex::sampleNextUniforms(x.data(), FMB_LENGTH, -8.0, 8.0);
+
+		stopwatch::tic();
+		for (uint r = 0; r < FMB_REPEATS; r++) {
+			alg::copy(x.data(), a.data(), FMB_LENGTH);
+			kernels::activate<double, Exact>(a.data(), dadz.data(), FMB_LENGTH);
+			std::atomic_signal_fence(std::memory_order_seq_cst);
+		}
+		double exactTime = stopwatch::tocGet();
+
+		stopwatch::tic();
+		for (uint r = 0; r < FMB_REPEATS; r++) {
+			alg::copy(x.data(), a.data(), FMB_LENGTH);
+			kernels::activate<double, Fast>(a.data(), dadz.data(), FMB_LENGTH);
+			std::atomic_signal_fence(std::memory_order_seq_cst);
+		}
+		double fastTime = stopwatch::tocGet();
+
+		std::cout << Functions<double>::getFunctionName(Exact::TYPE) << " kernel: exact "
+			<< exactTime << "s, fast " << fastTime << "s, speedup " << exactTime / fastTime << std::endl;
+	}
+
+	/* Trains the deep sigmoid XOR gate with given math mode
+	 */
+	void fmb_XORGateDeep(MathMode mode) {
+		rand_ex::reset();
+		Network<double> net(2, FunctionTypes::sigmoid, { 2, 2, 1 }, 1.0);
+		net.getHParams().set(FAST_MATH, mode == MathMode::fast ? 1.0 : 0.0);
+
+		VMatrix<double> input(
+			{
+				{0.0, 0.0},
+				{0.0, 1.0},
+				{1.0, 0.0},
+				{1.0, 1.0}
+			}
+		);
+
+		VMatrix<double> output(
+			{
+				{0.0},
+				{1.0},
+				{1.0},
+				{0.0}
+			}
+		);
+
+		net.addExample(input, output);
+		net.train();
+
+		std::cout << net << std::endl;
+	}
+
+	/* Runs all benchmarks
+	 */
+	void runFastMathBenchmark() {
+		fmb_compareAll<double>();
+		fmb_compareAll<float>();
+
+		fmb_kernel<activation::Sigmoid, activation::FastSigmoid>();
+		fmb_kernel<activation::Softplus, activation::FastSoftplus>();
+		fmb_kernel<activation::TanH, activation::FastTanH>();
+		if (!fast_math::IS_FASTER<double>) {
+			std::cout << "double does not vectorise on this target, MathMode::fast keeps libm for double" << std::endl;
+		}
+
+		std::cout << "XOR Deep Gate exact:" << std::endl;
+		fmb_XORGateDeep(MathMode::exact);
+		std::cout << "XOR Deep Gate fast:" << std::endl;
+		fmb_XORGateDeep(MathMode::fast);
+	}
+}
+
+#endif
\ No newline at end of file
@@ -3,6 +3,12 @@
 #ifndef __FULL_NETWORK__
 #define __FULL_NETWORK__
 
+#include <stdlib.h>
+
+#include <iostream>
+#include <thread>
+#include <vector>
+
 #include "network.hpp"
 
 namespace tests {
@@ -97,6 +103,116 @@ namespace tests {
 		net.predict(input);
 	}
 
+	/* Trains an xor gate, then makes predictions from many threads at once
+	 * Each thread should produce the same prediction
+	 */
+	void fn_concurrentPrediction() {
+		Network<double> net(2, FunctionTypes::sigmoid, { 2, 1 }, 1.0);
+
+		VMatrix<double> input(
+			{
+				{0.0, 0.0},
+				{0.0, 1.0},
+				{1.0, 0.0},
+				{1.0, 1.0}
+			}
+		);
+
+		VMatrix<double> output(
+			{
+				{0.0},
+				{1.0},
+				{1.0},
+				{0.0}
+			}
+		);
+
+		net.addExample(input, output);
+		net.train();
+
+		const Network<double>& trained = net;
+		VMatrix<double> expected = trained.makePrediction(input);
+
+		// char rather than bool, as vector<bool> packs threads into shared bytes
+		const uint THREADS = 4;
+		std::vector<char> matches(THREADS, true);
+		std::vector<std::thread> threads;
+
+		for (uint t = 0; t < THREADS; t++) {
+			threads.push_back(std::thread(
+				[&trained, &input, &expected, &matches, t]() {
+					for (uint i = 0; i < 10000; i++) {
+						VMatrix<double> prediction = trained.makePrediction(input);
+						matches[t] = matches[t] && (prediction - expected).sum() == 0.0;
+					}
+				}
+			));
+		}
+
+		for (auto& thread : threads) {
+			thread.join();
+		}
+
+		bool failed = false;
+		for (uint t = 0; t < THREADS; t++) {
+			std::cout << "Thread " << t << ": " << (matches[t] ? "MATCH" : "MISMATCH") << std::endl;
+			failed = failed || !matches[t];
+		}
+		std::cout << expected.transpose() << std::endl;
+
+		if (failed) {
+			std::cerr << "Concurrent predictions differ from single threaded prediction" << std::endl;
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	/* Trains the deep xor gate, evaluating cost at different intervals
+	 * Both should converge in a similar number of iterations
+	 */
+	void fn_costInterval() {
+		for (double interval : { 1.0, 16.0 }) {
+			rand_ex::reset();
+			Network<double> net(2, FunctionTypes::sigmoid, { 2, 2, 1 }, 1.0);
+			net.getHParams().set(COST_INTERVAL, interval);
+
+			VMatrix<double> input(
+				{
+					{0.0, 0.0},
+					{0.0, 1.0},
+					{1.0, 0.0},
+					{1.0, 1.0}
+				}
+			);
+
+			VMatrix<double> output(
+				{
+					{0.0},
+					{1.0},
+					{1.0},
+					{0.0}
+				}
+			);
+
+			net.addExample(input, output);
+			net.train();
+
+			std::cout << "Cost interval " << interval << ":" << std::endl;
+			std::cout << net << std::endl;
+		}
+	}
+
+	/* Prints memory used by training the line trial topology
+	 * Peak should be below the unshared total
+	 */
+	void fn_memoryReport() {
+		// Report only reads the network, so may be taken through a const reference
+		const Network<double> net(16, FunctionTypes::sigmoid, { 4, 2 }, 1.0);
+		std::cout << net.memoryReport(256) << std::endl;
+
+		Network<double> deep(2, FunctionTypes::sigmoid, { 8, 8, 8, 1 }, 1.0);
+		std::cout << deep.memoryReport(256) << std::endl;
+	}
+
 	/* Runs all test
 	*/
 	void runFullNetworkTests() {
@@ -112,6 +228,18 @@ namespace tests {
 		fn_XORGateDeep();
 		std::cout << std::endl;
 
+		std::cout << "Concurrent prediction:" << std::endl;
+		fn_concurrentPrediction();
+		std::cout << std::endl;
+
+		std::cout << "Cost interval:" << std::endl;
+		fn_costInterval();
+		std::cout << std::endl;
+
+		std::cout << "Memory report:" << std::endl;
+		fn_memoryReport();
+		std::cout << std::endl;
+
 	}
 }
 
@@ -8,6 +8,7 @@
 #include <map>
 #include <math.h> 
 
+#include "fast_math.hpp"
 #include "types.hpp"
 
 
@@ -18,6 +19,15 @@ enum FunctionTypes {
 	ReLU,
 	LeakyReLU,
 	softplus,
+	tanH,
+	linear,
+};
+
+// Accuracy of exp and log based activation functions
+// exact uses libm, fast uses fast_math approximations
+enum class MathMode {
+	exact,
+	fast,
 };
 
 // Map of FunctionTypes to string name
@@ -25,7 +35,9 @@ const std::map<FunctionTypes, std::string> FUNCTION_TYPES_TO_NAME = {
 	{sigmoid, "sigmoid"},
 	{ReLU, "ReLU"},
 	{LeakyReLU, "LeakyReLU"},
-	{softplus, "softplus"}
+	{softplus, "softplus"},
+	{tanH, "tanh"},
+	{linear, "linear"}
 };
 
 // List of templated functions for use
@@ -75,6 +87,26 @@ public:
 		return sigmoid(x);
 	}
 
+	// Implementation of tanh
+	static T tanH(T x) {
+		return tanh(x);
+	}
+
+	// Implementation of tanh derivative
+	static T tanHDerivative(T x) {
+		return T(1) - tanh(x) * tanh(x);
+	}
+
+	// Implementation of linear
+	static T linear(T x) {
+		return x;
+	}
+
+	// Implementation of linear derivative
+	static T linearDerivative(T x) {
+		return T(1);
+	}
+
 	// Returns corresponding function
 	static function_ptr getFunction(FunctionTypes type) {
 		switch (type) {
@@ -90,6 +122,12 @@ public:
 		case FunctionTypes::softplus:
 			return Functions::softplus;
 
+		case FunctionTypes::tanH:
+			return Functions::tanH;
+
+		case FunctionTypes::linear:
+			return Functions::linear;
+
 		default:
 			return nullptr;
 		}
@@ -98,7 +136,7 @@ public:
 	// Returns a string name to a corresponding function type
 	static std::string getFunctionName(FunctionTypes type) {
 		if (FUNCTION_TYPES_TO_NAME.count(type)) {
-			return FUNCTION_TYPES_TO_NAME[type];
+			return FUNCTION_TYPES_TO_NAME.at(type);
 		}
 		else {
 			return "None";
@@ -130,10 +168,160 @@ public:
 		case FunctionTypes::softplus:
 			return Functions::softplusDerivative;
 
+		case FunctionTypes::tanH:
+			return Functions::tanHDerivative;
+
+		case FunctionTypes::linear:
+			return Functions::linearDerivative;
+
 		default:
 			return nullptr;
 		}
 	}
 };
 
+/* Activation policies
+ * Each policy exposes an activation and its derivative as static functions,
+ * so kernels templated on a policy can inline and vectorise the element loop
+ * rather than going through a function_ptr per element
+ */
+namespace activation {
+	// Sigmoid policy
+	struct Sigmoid {
+		static constexpr FunctionTypes TYPE = FunctionTypes::sigmoid;
+
+		template <typename T>
+		static T function(T x) {
+			return T(1) / (T(1) + exp(-x));
+		}
+
+		// Derivative at x, a is function(x) which has already been computed
+		template <typename T>
+		static T derivative(T, T a) {
+			return a * (T(1) - a);
+		}
+	};
+
+	// ReLU policy
+	struct ReLU {
+		static constexpr FunctionTypes TYPE = FunctionTypes::ReLU;
+
+		template <typename T>
+		static T function(T x) {
+			return x < T(0) ? T(0) : x;
+		}
+
+		template <typename T>
+		static T derivative(T x, T) {
+			return x < T(0) ? T(0) : T(1);
+		}
+	};
+
+	// LeakyReLU policy
+	struct LeakyReLU {
+		static constexpr FunctionTypes TYPE = FunctionTypes::LeakyReLU;
+
+		template <typename T>
+		static T function(T x) {
+			return x < T(0) ? T(0.1) * x : x;
+		}
+
+		template <typename T>
+		static T derivative(T x, T) {
+			return x < T(0) ? T(0.1) : T(1);
+		}
+	};
+
+	// Softplus policy
+	struct Softplus {
+		static constexpr FunctionTypes TYPE = FunctionTypes::softplus;
+
+		template <typename T>
+		static T function(T x) {
+			return log(T(1.0) + exp(x));
+		}
+
+		template <typename T>
+		static T derivative(T x, T) {
+			return Sigmoid::function(x);
+		}
+	};
+
+	// Tanh policy
+	struct TanH {
+		static constexpr FunctionTypes TYPE = FunctionTypes::tanH;
+
+		template <typename T>
+		static T function(T x) {
+			return tanh(x);
+		}
+
+		template <typename T>
+		static T derivative(T, T a) {
+			return T(1) - a * a;
+		}
+	};
+
+	// Linear policy, output is the linear combination
+	struct Linear {
+		static constexpr FunctionTypes TYPE = FunctionTypes::linear;
+
+		template <typename T>
+		static T function(T x) {
+			return x;
+		}
+
+		template <typename T>
+		static T derivative(T, T) {
+			return T(1);
+		}
+	};
+
+	// Sigmoid policy using fast_math
+	struct FastSigmoid {
+		static constexpr FunctionTypes TYPE = FunctionTypes::sigmoid;
+
+		template <typename T>
+		static T function(T x) {
+			return fast_math::sigmoid(x);
+		}
+
+		template <typename T>
+		static T derivative(T, T a) {
+			return a * (T(1) - a);
+		}
+	};
+
+	// Softplus policy using fast_math
+	struct FastSoftplus {
+		static constexpr FunctionTypes TYPE = FunctionTypes::softplus;
+
+		template <typename T>
+		static T function(T x) {
+			return fast_math::softplus(x);
+		}
+
+		// sigmoid(x) = 1 - e^-a, as a = log(1 + e^x)
+		template <typename T>
+		static T derivative(T, T a) {
+			return -fast_math::expm1(-a);
+		}
+	};
+
+	// Tanh policy using fast_math
+	struct FastTanH {
+		static constexpr FunctionTypes TYPE = FunctionTypes::tanH;
+
+		template <typename T>
+		static T function(T x) {
+			return fast_math::tanh(x);
+		}
+
+		template <typename T>
+		static T derivative(T, T a) {
+			return T(1) - a * a;
+		}
+	};
+}
+
 #endif
\ No newline at end of file
@@ -0,0 +1,87 @@
+/* Benchmark of growing networks
+ * Compares time to threshold of a small network grown on each plateau
+ * against fixed size networks, and against retraining larger fixed sizes
+ * from scratch until one converges, when the size needed is unknown */
+#ifndef __GROWTH_BENCHMARK__
+#define __GROWTH_BENCHMARK__
+
+#include <math.h>
+
+#include <iostream>
+
+#include "network.hpp"
+
+namespace tests {
+	// Size of generated set
+	const uint GB_EXAMPLES = 1024;
+	const uint GB_INPUTS = 4;
+
+	/* Generates a smooth regression set, too hard for a couple of nodes
+	 * Output is 0.5 sin(3a) cos(2b) + 0.3 cd
+	 */
+	void gb_generate(VMatrix<double>& input, VMatrix<double>& output) {
+		input.qFill(GB_INPUTS, GB_EXAMPLES, 0.0);
+		output.qFill(1, GB_EXAMPLES, 0.0);
+		rand_ex::seed(7);
+		rand_ex::sampleNextUniforms(input.qGet(), input.getLength(), -1.0, 1.0);
+		rand_ex::reset();
+		for (uint j = 0; j < GB_EXAMPLES; j++) {
+			output.set(0, j, 0.5 * sin(3.0 * input.get(0, j)) * cos(2.0 * input.get(1, j)) + 0.3 * input.get(2, j) * input.get(3, j));
+		}
+	}
+
+	/* Trains a tanh network of given hidden width, growing up to growLimit times on a plateau
+	 * prints and returns time taken, negative if it did not reach threshold
+	 */
+	double gb_train(std::string name, uint width, uint growLimit, double threshold,
+		const VMatrix<double>& input, const VMatrix<double>& output) {
+
+		rand_ex::reset();
+		Network<double> net(GB_INPUTS, FunctionTypes::tanH, { width, 1 }, 0.02);
+		net.initialise(InitialisationTypes::automatic);
+		net.getHParams().set(OPTIMIZER, (double)OptimizerTypes::adam);
+		net.getHParams().set(CONVERGENCE_THRESHOLD, threshold);
+		net.getHParams().set(ITERATION_MAX, 50000.0);
+		net.getHParams().set(COST_INTERVAL, 100.0);
+		net.getHParams().set(PLATEAU, 5.0);
+		net.getHParams().set(PLATEAU_TOLERANCE, 1e-3);
+		net.getHParams().set(GROW_LIMIT, growLimit);
+
+		net.addExample(input, output);
+		net.train();
+
+		std::cout << "  " << name << " " << STOP_REASONS_TO_NAME.at(net.getStopReason()) << " in " << net.getExecutionTime()
+			<< "s, " << net.getIterations() << " iterations, cost " << net.getCost() << ", width " << net.getLayer(0).getNodeCount()
+			<< " after " << net.getGrowthCount() << " growths" << std::endl;
+		return net.isConverged() ? net.getExecutionTime() : -net.getExecutionTime();
+	}
+
+	/* Runs all benchmarks
+	 */
+	void runGrowthBenchmark() {
+		VMatrix<double> input(1, 1, 0.0), output(1, 1, 0.0);
+		gb_generate(input, output);
+
+		const double thresholds[] = { 5.0, 2.5 };
+		for (auto threshold : thresholds) {
+			std::cout << "Generated " << GB_EXAMPLES << ", threshold " << threshold << ":" << std::endl;
+			gb_train("fixed 2 ", 2, 0, threshold, input, output);
+			gb_train("fixed 12", 12, 0, threshold, input, output);
+
+			// Doubling width from scratch, until one reaches threshold
+			double total = 0.0;
+			for (uint width = 2; width <= 32; width *= 2) {
+				const double time = gb_train("scratch " + std::to_string(width), width, 0, threshold, input, output);
+				total += fabs(time);
+				if (time > 0.0) {
+					break;
+				}
+			}
+			std::cout << "  scratch total " << total << "s" << std::endl;
+
+			gb_train("grown   ", 2, 10, threshold, input, output);
+		}
+	}
+}
+
+#endif
\ No newline at end of file
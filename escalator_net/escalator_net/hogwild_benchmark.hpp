@@ -0,0 +1,55 @@
+/* Benchmark of Hogwild training
+ * Compares throughput over thread counts, and convergence
+ * against synchronous data parallel training */
+#ifndef __HOGWILD_BENCHMARK__
+#define __HOGWILD_BENCHMARK__
+
+#include <iostream>
+
+#include "data_parallel_benchmark.hpp"
+
+namespace tests {
+	// Examples in each mini batch
+	const uint HB_BATCH = 64;
+
+	// Epochs over the generated set
+	const uint HB_EPOCHS = 10;
+
+	/* Trains on the generated set in mini batches, with or without Hogwild
+	 * from the same initial weights, and prints throughput and cost
+	 */
+	void hb_train(uint threads, bool hogwild, const VMatrix<double>& input, const VMatrix<double>& output) {
+		rand_ex::reset();
+		Network<double> net(DPB_INPUTS, FunctionTypes::tanH, { 16, 1 }, 0.05);
+		net.getHParams().set(THREAD_COUNT, threads);
+		net.getHParams().set(HOGWILD, hogwild ? 1.0 : 0.0);
+		net.getHParams().set(BATCH_SIZE, HB_BATCH);
+		net.getHParams().set(ITERATION_MAX, HB_EPOCHS * DPB_EXAMPLES / HB_BATCH);
+		net.getHParams().set(CONVERGENCE_THRESHOLD, 0.0);
+
+		net.addExample(input, output);
+		net.train();
+
+		std::cout << "  " << threads << " threads: " << HB_EPOCHS * DPB_EXAMPLES / net.getExecutionTime()
+			<< " examples/s, epoch cost " << net.getCost() << std::endl;
+	}
+
+	/* Runs all benchmarks
+	 */
+	void runHogwildBenchmark() {
+		VMatrix<double> input(1, 1, 0.0), output(1, 1, 0.0);
+		dpb_generate(input, output);
+
+		std::cout << "Synchronous:" << std::endl;
+		for (uint threads : { 1, 2, 4 }) {
+			hb_train(threads, false, input, output);
+		}
+
+		std::cout << "Hogwild:" << std::endl;
+		for (uint threads : { 2, 4 }) {
+			hb_train(threads, true, input, output);
+		}
+	}
+}
+
+#endif
\ No newline at end of file
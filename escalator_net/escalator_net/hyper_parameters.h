@@ -9,6 +9,32 @@
 #define CONVERGENCE_THRESHOLD "convergence_threshold"
 #define ITERATION_MAX "iteration_max"
 #define LEARNING_RATE "learning_rate"
+#define FAST_MATH "fast_math"
+#define COST_INTERVAL "cost_interval"
+#define BATCH_SIZE "batch_size"
+#define SHUFFLE "shuffle"
+#define OPTIMIZER "optimizer"
+#define BETA1 "beta1"
+#define BETA2 "beta2"
+#define EPSILON "epsilon"
+#define LBFGS_HISTORY "lbfgs_history"
+#define LBFGS_MAX_STEP "lbfgs_max_step"
+#define LBFGS_RESTARTS "lbfgs_restarts"
+#define LBFGS_STALL "lbfgs_stall"
+#define THREAD_COUNT "threads"
+#define HOGWILD "hogwild"
+#define LOSS "loss"
+#define VALIDATION_SPLIT "validation_split"
+#define PATIENCE "patience"
+#define PLATEAU "plateau"
+#define PLATEAU_TOLERANCE "plateau_tolerance"
+#define SAMPLING "sampling"
+#define REFRESH_INTERVAL "refresh_interval"
+#define DEDUPLICATE "deduplicate"
+#define GROW_LIMIT "grow_limit"
+#define GROW_WIDTH "grow_width"
+#define GROW_DEPTH "grow_depth"
+#define NORMALISE "normalise"
 
 class HyperParameters {
 	// Internal parameters
@@ -16,6 +42,56 @@ class HyperParameters {
 		{ CONVERGENCE_THRESHOLD, 0.01 },
 		{ ITERATION_MAX, 3000000.0 },
 		{ LEARNING_RATE, 1.0 },
+		// 0 for exact activation functions, 1 for fast approximations where they vectorise
+		{ FAST_MATH, 0.0 },
+		// Cost is evaluated for convergence every this many epochs
+		{ COST_INTERVAL, 1.0 },
+		// Examples per iteration, 0 for the whole training set
+		{ BATCH_SIZE, 0.0 },
+		// 1 to shuffle examples before each epoch of mini batches
+		{ SHUFFLE, 1.0 },
+		// Value of OptimizerTypes, 0 for SGD
+		{ OPTIMIZER, 0.0 },
+		// Momentum, or first moment decay of adam
+		{ BETA1, 0.9 },
+		// Second moment decay of RMSProp and adam
+		{ BETA2, 0.999 },
+		{ EPSILON, 1e-8 },
+		// Number of steps remembered by L-BFGS
+		{ LBFGS_HISTORY, 10.0 },
+		// Largest change in parameters of an L-BFGS iteration
+		{ LBFGS_MAX_STEP, 1.0 },
+		// Times L-BFGS may start again from new weights once it stalls short of convergence, 0 never restarts
+		{ LBFGS_RESTARTS, 0.0 },
+		// L-BFGS iterations without a relative fall of 1% in cost before it has stalled
+		{ LBFGS_STALL, 100.0 },
+		// Number of threads each batch is split over
+		{ THREAD_COUNT, 1.0 },
+		// 1 for each thread to take its own batches and update with plain SGD without locks
+		{ HOGWILD, 0.0 },
+		// Value of LossTypes, 0 for squared error
+		{ LOSS, 0.0 },
+		// Fraction of examples held out to evaluate validation cost
+		{ VALIDATION_SPLIT, 0.0 },
+		// Cost evaluations without lower validation cost before stopping, 0 never stops
+		{ PATIENCE, 0.0 },
+		// Cost evaluations without a relative fall of PLATEAU_TOLERANCE in cost before stopping, 0 never stops
+		{ PLATEAU, 0.0 },
+		{ PLATEAU_TOLERANCE, 1e-6 },
+		// 1 to draw mini batches in proportion to the loss of each example, 0 for uniform
+		{ SAMPLING, 0.0 },
+		// Epochs between full passes refreshing loss of each example for sampling
+		{ REFRESH_INTERVAL, 10.0 },
+		// 1 to store repeated examples once, weighted by the number of times added
+		{ DEDUPLICATE, 0.0 },
+		// Times the network grows instead of stopping on a plateau, 0 never grows
+		{ GROW_LIMIT, 0.0 },
+		// Nodes added to each hidden layer when growing
+		{ GROW_WIDTH, 2.0 },
+		// Layers inserted before the output layer when growing
+		{ GROW_DEPTH, 0.0 },
+		// Value of NormalisationTypes applied to input, 0 for none
+		{ NORMALISE, 0.0 },
 	};
 	// TODO make strict
 public:
@@ -24,6 +100,11 @@ public:
 		parameters[name] = value;
 	}
 
+	// Returns true if name is a known parameter
+	bool has(std::string name) const {
+		return parameters.count(name) != 0;
+	}
+
 	// Gets a parameter
 	double get(std::string name) const {
 		return (*parameters.find(name)).second;
@@ -0,0 +1,129 @@
+/* Draws examples in proportion to an estimate of their loss
+ * Each draw is weighted by 1 / (N p), so the weighted mean gradient
+ * of a batch is an unbiased estimate of the mean gradient over all examples
+ * An example with a count c stands for c identical examples, so is drawn c times as often
+ * and weighted by c / (W p), where W is the sum of counts
+ */
+#ifndef __IMPORTANCE_SAMPLER__
+#define __IMPORTANCE_SAMPLER__
+
+#include <algorithm>
+#include <vector>
+
+#include "rand_ex.hpp"
+#include "types.hpp"
+
+template <typename T>
+class ImportanceSampler {
+	// Estimate of loss of each example
+	std::vector<T> losses;
+
+	// Number of identical examples each example stands for, empty if each is one
+	std::vector<T> counts;
+
+	// Sum of counts
+	double countTotal = 0.0;
+
+	// Probability of each example, built from losses
+	std::vector<double> probability;
+
+	/* Alias table, so each draw takes constant time
+	 * Slot i is example i with chance threshold[i], otherwise example alias[i]
+	 */
+	std::vector<double> threshold;
+	std::vector<uint> alias;
+
+	// Uniform values used for a batch of draws
+	std::vector<double> uniforms;
+
+	// Fraction of probability spread evenly, so every example is drawn sometimes
+	static constexpr double UNIFORM_MIX = 0.1;
+
+public:
+	// Sets number of examples, and optionally count of each, estimates start equal
+	void resize(uint count, const T* weights = nullptr) {
+		losses.assign(count, T(1));
+		counts.assign(weights, weights ? weights + count : weights);
+		countTotal = weights ? 0.0 : (double)count;
+		for (auto i : counts) {
+			countTotal += (double)i;
+		}
+		probability.resize(count);
+		threshold.resize(count);
+		alias.resize(count);
+	}
+
+	// Returns estimate of loss of each example
+	T* getLosses() {
+		return losses.data();
+	}
+
+	// Returns sum of estimates, each multiplied by its count
+	T getTotal() const {
+		T total = T(0);
+		for (uint i = 0; i < losses.size(); i++) {
+			total += counts.empty() ? losses[i] : counts[i] * losses[i];
+		}
+		return total;
+	}
+
+	// Updates estimates of count examples at indices
+	void update(const uint* indices, const T* costs, uint count) {
+		for (uint i = 0; i < count; i++) {
+			losses[indices[i]] = costs[i];
+		}
+	}
+
+	// Rebuilds distribution from current estimates, must be called before sampling
+	void build() {
+		const uint n = (uint)losses.size();
+		const double total = (double)getTotal();
+		const double mix = total > 0.0 ? UNIFORM_MIX : 1.0;
+
+		// Split slots into those under and over an even share, then fill each under from an over
+		std::vector<uint> under, over;
+		for (uint i = 0; i < n; i++) {
+			const double c = counts.empty() ? 1.0 : (double)counts[i];
+			probability[i] = (1.0 - mix) * (total > 0.0 ? c * (double)losses[i] / total : 0.0) + mix * c / countTotal;
+			threshold[i] = probability[i] * n;
+			alias[i] = i;
+			(threshold[i] < 1.0 ? under : over).push_back(i);
+		}
+
+		while (!under.empty() && !over.empty()) {
+			const uint u = under.back(), o = over.back();
+			under.pop_back();
+			alias[u] = o;
+			threshold[o] -= 1.0 - threshold[u];
+			if (threshold[o] < 1.0) {
+				over.pop_back();
+				under.push_back(o);
+			}
+		}
+
+		// Left over slots are only short from rounding
+		for (auto i : under) {
+			threshold[i] = 1.0;
+		}
+		for (auto i : over) {
+			threshold[i] = 1.0;
+		}
+	}
+
+	// Draws count examples with replacement, setting indices and weight of each
+	void sample(uint* indices, T* weights, uint count) {
+		const uint n = (uint)losses.size();
+		uniforms.resize(2 * (size_t)count);
+		rand_ex::sampleNextUniforms(uniforms.data(), 2 * count, 0.0, 1.0);
+
+		for (uint i = 0; i < count; i++) {
+			const uint slot = (std::min)((uint)(uniforms[2 * i] * n), n - 1);
+			const uint j = uniforms[2 * i + 1] < threshold[slot] ? slot : alias[slot];
+			indices[i] = j;
+			const double c = counts.empty() ? 1.0 : (double)counts[j];
+			weights[i] = T(c / (countTotal * probability[j]));
+		}
+	}
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,81 @@
+/* Benchmark of importance sampling
+ * Compares time to threshold of mini batches drawn in proportion to loss
+ * against uniform mini batches, on the line trial and a large generated set */
+#ifndef __IMPORTANCE_SAMPLING_BENCHMARK__
+#define __IMPORTANCE_SAMPLING_BENCHMARK__
+
+#include <iostream>
+
+#include "line_trial.hpp"
+#include "network.hpp"
+
+namespace tests {
+	// Size of generated set
+	const uint ISB_EXAMPLES = 16384;
+	const uint ISB_INPUTS = 16;
+
+	/* Generates a large set, most of which is easy
+	 * Output is 1 where sum of input is positive
+	 */
+	void isb_generate(VMatrix<double>& input, VMatrix<double>& output) {
+		input.qFill(ISB_INPUTS, ISB_EXAMPLES, 0.0);
+		output.qFill(1, ISB_EXAMPLES, 0.0);
+		rand_ex::seed(3);
+		rand_ex::sampleNextUniforms(input.qGet(), input.getLength(), -1.0, 1.0);
+		rand_ex::reset();
+		for (uint j = 0; j < ISB_EXAMPLES; j++) {
+			double sum = 0.0;
+			for (uint i = 0; i < ISB_INPUTS; i++) {
+				sum += input.get(i, j);
+			}
+			output.set(0, j, sum > 0.0 ? 1.0 : 0.0);
+		}
+	}
+
+	/* Trains a network with uniform or importance sampled batches from the same weights
+	 * and prints time and iterations to threshold
+	 */
+	void isb_train(bool importance, uint inputWidth, FunctionTypes type, std::vector<uint> nodeCounts, double learningRate,
+		LossTypes loss, uint batchSize, double threshold, const VMatrix<double>& input, const VMatrix<double>& output) {
+
+		rand_ex::reset();
+		Network<double> net(inputWidth, type, nodeCounts, learningRate);
+		net.getHParams().set(SAMPLING, importance ? 1.0 : 0.0);
+		net.getHParams().set(LOSS, (double)loss);
+		net.getHParams().set(BATCH_SIZE, batchSize);
+		net.getHParams().set(CONVERGENCE_THRESHOLD, threshold);
+		net.getHParams().set(ITERATION_MAX, 200000.0);
+
+		net.addExample(input, output);
+		net.train();
+
+		std::cout << "  " << (importance ? "importance" : "uniform   ") << " "
+			<< STOP_REASONS_TO_NAME.at(net.getStopReason()) << " in " << net.getExecutionTime() << "s, "
+			<< net.getIterations() << " iterations, cost " << net.getCost() << std::endl;
+	}
+
+	/* Runs all benchmarks
+	 */
+	void runImportanceSamplingBenchmark() {
+		LineTrialMaster master = lt_getMaster();
+		VMatrix<double> lineInput = master.getInput(16), lineOutput = master.getOutput(2);
+
+		std::cout << "Line trial, batches of 4:" << std::endl;
+		isb_train(false, 16, FunctionTypes::sigmoid, { 4, 2 }, 1.0, LossTypes::squaredError, 4, 0.01, lineInput, lineOutput);
+		isb_train(true, 16, FunctionTypes::sigmoid, { 4, 2 }, 1.0, LossTypes::squaredError, 4, 0.01, lineInput, lineOutput);
+
+		VMatrix<double> input(1, 1, 0.0), output(1, 1, 0.0);
+		isb_generate(input, output);
+
+		// Easy examples keep some squared error, but near none of cross entropy
+		std::cout << "Generated " << ISB_EXAMPLES << ", batches of 64, squared error:" << std::endl;
+		isb_train(false, ISB_INPUTS, FunctionTypes::tanH, { 8, 1 }, 0.2, LossTypes::squaredError, 64, 100.0, input, output);
+		isb_train(true, ISB_INPUTS, FunctionTypes::tanH, { 8, 1 }, 0.2, LossTypes::squaredError, 64, 100.0, input, output);
+
+		std::cout << "Generated " << ISB_EXAMPLES << ", batches of 64, cross entropy:" << std::endl;
+		isb_train(false, ISB_INPUTS, FunctionTypes::tanH, { 8, 1 }, 0.2, LossTypes::sigmoidCrossEntropy, 64, 200.0, input, output);
+		isb_train(true, ISB_INPUTS, FunctionTypes::tanH, { 8, 1 }, 0.2, LossTypes::sigmoidCrossEntropy, 64, 200.0, input, output);
+	}
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,103 @@
+/* Schemes for initial weights of a layer
+ * Each scheme scales a symmetric uniform range by the fan in and fan out of the layer
+ * so the variance of activations stays near constant through deep networks
+ */
+#ifndef __INITIALISATION__
+#define __INITIALISATION__
+
+#include <math.h>
+
+#include <map>
+#include <string>
+
+#include "functions.hpp"
+#include "rand_ex.hpp"
+#include "types.hpp"
+
+// Different schemes of initial weights
+enum class InitialisationTypes {
+	// Weights from U(0, 1)
+	uniform = 0,
+	// Chosen from activation function, xavier for saturating functions, he for rectifiers
+	automatic = 1,
+	// Glorot and Bengio, variance 2 / (fanIn + fanOut)
+	xavier = 2,
+	// He et al, variance 2 / fanIn
+	he = 3,
+	// LeCun, variance 1 / fanIn
+	lecun = 4,
+};
+
+// Map of InitialisationTypes to string name
+const std::map<InitialisationTypes, std::string> INITIALISATION_TYPES_TO_NAME = {
+	{InitialisationTypes::uniform, "uniform"},
+	{InitialisationTypes::automatic, "automatic"},
+	{InitialisationTypes::xavier, "xavier"},
+	{InitialisationTypes::he, "he"},
+	{InitialisationTypes::lecun, "lecun"}
+};
+
+namespace initialisation {
+	// Returns scheme used by automatic for an activation function
+	inline InitialisationTypes getAutomatic(FunctionTypes type) {
+		switch (type) {
+		case ReLU:
+		case LeakyReLU:
+			return InitialisationTypes::he;
+
+		default:
+			return InitialisationTypes::xavier;
+		}
+	}
+
+	// Returns initialisation type from a name, uniform if not found
+	inline InitialisationTypes getTypeFromName(std::string name) {
+		for (auto& i : INITIALISATION_TYPES_TO_NAME) {
+			if (i.second == name) {
+				return i.first;
+			}
+		}
+		return InitialisationTypes::uniform;
+	}
+
+	/* Fills weight of given length for a layer with given activation
+	 * fanIn is the number of weights summed into each node, which is less than the rows of an embedding
+	 * Symmetric schemes sample U(-r, r), which has variance r^2 / 3
+	 */
+	template <typename T>
+	void fillWeights(T* weight, uint length, uint fanIn, uint fanOut, FunctionTypes function, InitialisationTypes type) {
+		if (type == InitialisationTypes::automatic) {
+			type = getAutomatic(function);
+		}
+
+		double variance;
+		switch (type) {
+		case InitialisationTypes::xavier:
+			variance = 2.0 / (fanIn + fanOut);
+			break;
+
+		case InitialisationTypes::he:
+			variance = 2.0 / fanIn;
+			break;
+
+		case InitialisationTypes::lecun:
+			variance = 1.0 / fanIn;
+			break;
+
+		default:
+			rand_ex::sampleNextUniforms(weight, length, T(0.0), T(1.0));
+			return;
+		}
+
+		const T range = T(sqrt(3.0 * variance));
+		rand_ex::sampleNextUniforms(weight, length, -range, range);
+	}
+
+	// Fills weight of length fanIn * fanOut, for a layer where every row of weight is summed
+	template <typename T>
+	void fillWeights(T* weight, uint fanIn, uint fanOut, FunctionTypes function, InitialisationTypes type) {
+		fillWeights(weight, fanIn * fanOut, fanIn, fanOut, function, type);
+	}
+}
+
+#endif
\ No newline at end of file
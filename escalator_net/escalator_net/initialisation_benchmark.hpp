@@ -0,0 +1,101 @@
+/* Benchmark of initialisation schemes
+ * Compares convergence rate, iterations and time to threshold
+ * over a number of seeds on the test networks */
+#ifndef __INITIALISATION_BENCHMARK__
+#define __INITIALISATION_BENCHMARK__
+
+#include <iomanip>
+#include <iostream>
+
+#include "line_trial.hpp"
+#include "network.hpp"
+
+namespace tests {
+	// Seeds trained for each scheme
+	const uint IB_SEEDS = 8;
+
+	// Compared schemes, existing uniform first
+	const std::vector<InitialisationTypes> IB_SCHEMES = {
+		InitialisationTypes::uniform,
+		InitialisationTypes::xavier,
+		InitialisationTypes::he,
+		InitialisationTypes::lecun,
+	};
+
+	/* Trains a network from each seed with each scheme
+	 * and prints number converged, with mean iterations and time of those that did
+	 */
+	void ib_compare(std::string name, uint inputWidth, FunctionTypes type, std::vector<uint> nodeCounts,
+		const VMatrix<double>& input, const VMatrix<double>& output) {
+
+		std::cout << name << ":" << std::endl;
+		for (auto scheme : IB_SCHEMES) {
+			uint converged = 0;
+			double iterations = 0.0, time = 0.0;
+			for (uint seed = 0; seed < IB_SEEDS; seed++) {
+				rand_ex::seed(seed);
+				Network<double> net(inputWidth, type, nodeCounts, 1.0);
+				net.initialise(scheme);
+				net.getHParams().set(ITERATION_MAX, 100000.0);
+
+				net.addExample(input, output);
+				net.train();
+
+				if (net.isConverged()) {
+					converged++;
+					iterations += net.getIterations();
+					time += net.getExecutionTime();
+				}
+			}
+
+			std::cout << "  " << std::setw(10) << std::left << INITIALISATION_TYPES_TO_NAME.at(scheme)
+				<< converged << "/" << IB_SEEDS << " converged";
+			if (converged) {
+				std::cout << ", mean " << iterations / converged << " iterations, " << time / converged << "s";
+			}
+			std::cout << std::endl;
+		}
+		rand_ex::reset();
+	}
+
+	/* Runs all benchmarks
+	 */
+	void runInitialisationBenchmark() {
+		VMatrix<double> input(
+			{
+				{0.0, 0.0},
+				{0.0, 1.0},
+				{1.0, 0.0},
+				{1.0, 1.0}
+			}
+		);
+
+		VMatrix<double> xorOutput(
+			{
+				{0.0},
+				{1.0},
+				{1.0},
+				{0.0}
+			}
+		);
+
+		VMatrix<double> nxorOutput(
+			{
+				{1.0},
+				{0.0},
+				{0.0},
+				{1.0}
+			}
+		);
+
+		ib_compare("XOR Gate", 2, FunctionTypes::sigmoid, { 2, 1 }, input, xorOutput);
+		ib_compare("NXOR Gate", 2, FunctionTypes::softplus, { 2, 1 }, input, nxorOutput);
+		ib_compare("XOR Deep Gate", 2, FunctionTypes::sigmoid, { 2, 2, 1 }, input, xorOutput);
+		ib_compare("XOR Deep Gate tanh", 2, FunctionTypes::tanH, { 4, 4, 1 }, input, xorOutput);
+
+		LineTrialMaster master = lt_getMaster();
+		ib_compare("Line trial", 16, FunctionTypes::sigmoid, { 4, 2 }, master.getInput(16), master.getOutput(2));
+	}
+}
+
+#endif
\ No newline at end of file
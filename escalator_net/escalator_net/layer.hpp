@@ -3,103 +3,605 @@
 #ifndef __LAYER__
 #define __LAYER__
 
+#include <algorithm>
 #include <vector>
 
-#include "node.hpp"
+#include "convolution.hpp"
+#include "embedding.hpp"
+#include "functions.hpp"
+#include "initialisation.hpp"
+#include "layer_kernels.hpp"
+#include "optimizer.hpp"
+#include "rand_ex.hpp"
+#include "sparse.hpp"
+#include "vmatrix.hpp"
+
+/* Buffers used by a layer for an iteration of training
+ * Each is of size (batch, nodeCount), and owned by the caller
+ */
+template <typename T>
+struct LayerBuffers {
+	// Activation for this layer
+	T* activation = nullptr;
+
+	// Change in each activation relative to linear combination
+	// Becomes dC/dz after backwards propogation
+	T* dadz = nullptr;
+
+	// Change in cost relative to activation of each node
+	T* dcda = nullptr;
+
+	/* Working memory of layers over images, of size getScratchSize(batch)
+	 * columns of input for a convolution, or index of each maximum for max pooling
+	 */
+	T* scratch = nullptr;
+};
 
  /* A single layer of nodes
+  * Weights of all nodes are stored in a single matrix
+  * where each row is the i-th input and each column is a node
   */
 template <typename T>
 class Layer {
 private:
-	// input size of this node
-	const uint INPUTSIZE;
+	// input size of this node, only changed by growing
+	uint INPUTSIZE;
+
+	// Number of nodes in this layer, only changed by growing
+	uint NODECOUNT;
+
+	// Kind of layer and size of its image, if over an image
+	LayerShape shape;
 
-	// Nodes within this layer
-	std::vector<Node<T>> nodes;
+	// Activation function type
+	FunctionTypes activationFunctionType;
 
-	// Activation for this layer from last forward propogation
-	VMatrix<T> activation = VMatrix<T>(1, 1, T(0.0));
+	// True while a loss applies the output function of this layer, so its kernels are linear
+	// activationFunctionType is kept, for when the loss changes back
+	bool fusedOutput = false;
+
+	// Kernels for this layers activation function
+	kernels::KernelTable<T> kernel;
+
+	/// Layer parameters
+	/* Parameters, gradient and optimizer state, one after the other
+	 * Parameters are weight of size (inputSize, nodeCount), then bias of size (1, nodeCount)
+	 * A convolution shares weight of size (patchSize, filters) and bias of size (1, filters) over all windows
+	 * an embedding has weight of size (vocabulary, nodeCount), and max pooling has no parameters
+	 * gradient has the same layout, and is the change in cost averaged over input
+	 * optimizer state is a number of arrays of the same length as parameters
+	 */
+	std::vector<T> storage;
+
+	// Rows of weight gradient of an embedding set by setGradientRows, the only rows stepped while rowsOnly is set
+	std::vector<uint> gradientRows;
+	bool rowsOnly = false;
+
+	/* 1 for each weight kept, and 0 for each pruned, in the layout of weight
+	 * Gradient is multiplied by it, so pruned weights stay 0 while training
+	 * Empty if no weight has been pruned
+	 */
+	std::vector<T> mask;
+
+	// Weight of a pruned layer in compressed form, used for inference
+	SparseWeight<T> sparse;
 
 public:
-	/* Computes dCda for this layer,
-	 * each row is the next input, each column, dcda for ith node
-	 * Takes:
-	 * reference to previous layer (L+1) for values
-	 */
-	void setdcda(const Layer<T>& layer) {
-		
-		// go through each node, and compute dcda
-		int i = -1;
-		for (auto& node : nodes) {
-			i++;
-			VMatrix<T> dcda(1, node.getActivation().getColumnLength(), T(0.0));
-		
-			for (auto& nextNode : layer.nodes) {
-				dcda = dcda + nextNode.getdcda().elementMultiply(nextNode.getdadz()) * nextNode.getWeight(i);
+	// Creates this layer for a fixed sized input
+	// with given count of of nodes and activation function
+	Layer(uint inputSize, uint nodeCount, FunctionTypes activationFunction)
+		: Layer(inputSize, LayerShape::dense(nodeCount), activationFunction) {
+	}
+
+	/* Creates this layer of given shape for a fixed sized input
+	 * Max pooling takes the largest activation of the layer before, so is always linear
+	 */
+	Layer(uint inputSize, const LayerShape& layerShape, FunctionTypes activationFunction)
+		: INPUTSIZE(inputSize), NODECOUNT(layerShape.getNodeCount()), shape(layerShape),
+		activationFunctionType(layerShape.kind == LayerKinds::maxPool ? FunctionTypes::linear : activationFunction) {
+		if (shape.kind == LayerKinds::dense) {
+			shape.inputSize = inputSize;
+		}
+		assert(shape.getInputSize() == inputSize && "Shape must take the size of input");
+
+		storage.assign((size_t)2 * getParameterCount(), T(0));
+		kernel = kernels::getKernelTable<T>(activationFunctionType);
+		randomiseWeights();
+	}
+
+	/* Grows this layer to inputSize and nodeCount in place
+	 * Parameters, gradient and optimizer state keep their values, and new entries are 0
+	 * Each array is treated as INPUTSIZE + 1 rows of NODECOUNT, the last being bias
+	 * Rows are moved from the end of storage, as each only moves further along it
+	 */
+	void grow(uint inputSize, uint nodeCount) {
+		assert(isDense() && !isPruned() && "Only dense layers that are not pruned can grow");
+		assert(inputSize >= INPUTSIZE && nodeCount >= NODECOUNT && "Layers can only grow");
+
+		const size_t length = getParameterCount();
+		const size_t arrays = storage.size() / length;
+		const size_t nextLength = (size_t)(inputSize + 1) * nodeCount;
+		storage.resize(arrays * nextLength, T(0));
+
+		for (size_t a = arrays; a--;) {
+			T* from = storage.data() + a * length;
+			T* to = storage.data() + a * nextLength;
+
+			for (uint r = INPUTSIZE + 1; r--;) {
+				const T* row = from + (size_t)r * NODECOUNT;
+				T* nextRow = to + (size_t)(r < INPUTSIZE ? r : inputSize) * nodeCount;
+				if (nextRow != row) {
+					std::copy_backward(row, row + NODECOUNT, nextRow + NODECOUNT);
+				}
+				std::fill(nextRow + NODECOUNT, nextRow + nodeCount, T(0));
+
+				// New input rows, once bias has moved past them
+				if (r == INPUTSIZE) {
+					std::fill(to + (size_t)INPUTSIZE * nodeCount, to + (size_t)inputSize * nodeCount, T(0));
+				}
 			}
+		}
+
+		INPUTSIZE = inputSize;
+		NODECOUNT = nodeCount;
+		shape.inputSize = inputSize;
+		shape.nodeCount = nodeCount;
+	}
 
-			node.setdcda(dcda);
+	/* Adds a node for each of sources, with the weights and bias of that node
+	 * so each new node has the same activation as its source
+	 */
+	void insertNodes(const std::vector<uint>& sources) {
+		const uint first = NODECOUNT;
+		grow(INPUTSIZE, NODECOUNT + (uint)sources.size());
+
+		T* parameters = getParameters();
+		for (uint k = 0; k < sources.size(); k++) {
+			for (uint r = 0; r <= INPUTSIZE; r++) {
+				parameters[r * NODECOUNT + first + k] = parameters[r * NODECOUNT + sources[k]];
+			}
 		}
 	}
 
-	/* Sets dcda for the first layer
-	 * Takes as input, YObs, for this layer
-	 * sets dcda against 
+	/* Adds an input for each of sources, which takes shares[k] of the weights from that input
+	 * The source keeps the rest, so while the new input equals its source
+	 * the sum over a source and its copies, and so the output, is unchanged
 	 */
-	void setFirstdcda( const VMatrix<T> YObs) {
-		VMatrix<T> dcda = (activation - YObs) * T(2.0);
-		for (uint i = 0; i < nodes.size(); i++) {
-			nodes[i].setdcda(dcda.getColumn(i));
+	void insertInputs(const std::vector<uint>& sources, const std::vector<T>& shares) {
+		const uint first = INPUTSIZE;
+		grow(INPUTSIZE + (uint)sources.size(), NODECOUNT);
+
+		T* parameters = getParameters();
+		for (uint k = 0; k < sources.size(); k++) {
+			T* source = parameters + sources[k] * NODECOUNT;
+			T* copy = parameters + (first + k) * NODECOUNT;
+			for (uint j = 0; j < NODECOUNT; j++) {
+				copy[j] = shares[k] * source[j];
+				source[j] -= copy[j];
+			}
 		}
 	}
 
-	// Creates this layer for a fixed sized input
-	// with given count of of nodes and activation function
-	Layer(uint inputSize, uint nodeCount, FunctionTypes activationFunction)
-	: INPUTSIZE(inputSize) {
-		for (uint i = 0; i < nodeCount; i++) {
-			nodes.push_back(Node<T>(activationFunction, inputSize));
+	// Sets weights to the identity and bias to 0, layer must have as many nodes as inputs
+	void setIdentity() {
+		assert(isDense() && INPUTSIZE == NODECOUNT && "Identity requires a square dense layer");
+
+		std::fill(getParameters(), getParameters() + getParameterCount(), T(0));
+		for (uint i = 0; i < NODECOUNT; i++) {
+			getParameters()[i * NODECOUNT + i] = T(1);
+		}
+	}
+
+	// Randomises weights with given scheme, and sets bias to 0, no weight is left pruned
+	void randomiseWeights(InitialisationTypes type = InitialisationTypes::uniform) {
+		mask.clear();
+		sparse.clear();
+		if (!getParameterCount()) {
+			return;
 		}
+		initialisation::fillWeights(
+			getParameters(), getWeightRows() * getWeightColumns(), getFanIn(), getWeightColumns(), activationFunctionType, type
+		);
+		std::fill(getParameters() + getWeightRows() * getWeightColumns(), getParameters() + getParameterCount(), T(0));
 	}
-	
+
 	/* Applies forward propogation step
-	 * Takes array of input 
+	 * Takes input of size (batch, inputSize), owned by caller
 	 * each column is the i-th term in an input
 	 * and each row is a new input
+	 * Sets activation and dadz in buffers, both of size (batch, nodeCount)
+	 * A convolution runs the dense kernels over each window, as a batch of batch * positions
+	 */
+	void propogateForward(const T* input, uint batch, const LayerBuffers<T>& buffers) const {
+		switch (shape.kind) {
+		case LayerKinds::convolution:
+			kernels::im2col(input, batch, shape, buffers.scratch);
+			kernel.forward(
+				buffers.scratch, batch * shape.getPositions(), shape.getPatchSize(), getWeight().qGet(), getBias().qGet(),
+				shape.filters, buffers.activation, buffers.dadz
+			);
+			break;
+
+		case LayerKinds::maxPool:
+			kernels::maxPool(input, batch, shape, buffers.activation, buffers.scratch);
+			break;
+
+		case LayerKinds::embedding:
+			kernels::embed(
+				input, batch, INPUTSIZE, getWeight().qGet(), getBias().qGet(), shape.vocabulary, NODECOUNT, buffers.activation
+			);
+			kernel.activate(buffers.activation, buffers.dadz, batch * NODECOUNT);
+			break;
+
+		default:
+			kernel.forward(
+				input, batch, INPUTSIZE, getWeight().qGet(), getBias().qGet(), NODECOUNT, buffers.activation, buffers.dadz
+			);
+			break;
+		}
+	}
+
+	/* Applies forward propogation step with buffers owned by this call
 	 * returns matrix where each row is an input
 	 * and each column is the return from i-th node
 	 */
-	VMatrix<T> propogateForward(const VMatrix<T>& input, double LRATE) {
+	VMatrix<T> propogateForward(const VMatrix<T>& input) {
 		assert(INPUTSIZE == input.getRowLength());
-		// Results matrix, will be extended transposed
-		VMatrix<T> results(input.getColumnLength(), 0, T(0.0));
 
-		for (Node<T>& node : nodes) {
-			results.extend(node.forwardPropogation(input, LRATE).qTranspose());
-		}
+		const uint batch = input.getColumnLength();
+		VMatrix<T> activation(NODECOUNT, batch, T(0.0));
+		std::vector<T> dadz((size_t)NODECOUNT * batch);
+		std::vector<T> scratch(getScratchSize(batch));
 
-		activation.assign(results.transpose());
+		LayerBuffers<T> buffers;
+		buffers.activation = activation.qGet();
+		buffers.dadz = dadz.data();
+		buffers.scratch = scratch.data();
+		propogateForward(input.qGet(), batch, buffers);
 
 		return activation;
 	}
 
+	/* Applies forward propogation for inference
+	 * Only reads parameters, so may be called from many threads at once
+	 * input is (batch, inputSize) and output (batch, nodeCount), both owned by caller
+	 * A convolution also needs scratch of getScratchSize(batch)
+	 * If fused, the output function is left to a loss and z is returned
+	 */
+	void infer(const T* input, uint batch, T* output, MathMode mode, T* scratch = nullptr, bool fused = false) const {
+		const kernels::KernelTable<T> table = kernels::getKernelTable<T>(fused ? FunctionTypes::linear : activationFunctionType, mode);
+		switch (shape.kind) {
+		case LayerKinds::convolution:
+			assert(scratch && "Convolution requires scratch");
+			kernels::im2col(input, batch, shape, scratch);
+			table.infer(
+				scratch, batch * shape.getPositions(), shape.getPatchSize(), getWeight().qGet(), getBias().qGet(),
+				shape.filters, output
+			);
+			break;
+
+		case LayerKinds::maxPool:
+			kernels::maxPool(input, batch, shape, output, (T*)nullptr);
+			break;
+
+		case LayerKinds::embedding:
+			kernels::embed(input, batch, INPUTSIZE, getWeight().qGet(), getBias().qGet(), shape.vocabulary, NODECOUNT, output);
+			table.apply(output, batch * NODECOUNT);
+			break;
+
+		default:
+			if (!sparse.empty()) {
+				kernels::sparseLinear(input, batch, INPUTSIZE, sparse, getBias().qGet(), NODECOUNT, output);
+				table.apply(output, batch * NODECOUNT);
+				break;
+			}
+			table.infer(input, batch, INPUTSIZE, getWeight().qGet(), getBias().qGet(), NODECOUNT, output);
+			break;
+		}
+	}
+
 	/* Applies backward propogation step
+	 * Takes the same input as the last forward propogation
+	 * Requires dcda in buffers to have been set, dadz becomes dC/dz
+	 * Sets gradient, in the layout of parameters, to the sum over input times scale
+	 * If embeddingRows is given, an embedding only sets rows of its ids, and it must list the rows that may be non zero
+	 * Only reads parameters, so may be called from many threads at once
 	 */
-	void propogateBackwards() {
+	void propogateBackwards(const T* input, uint batch, const LayerBuffers<T>& buffers, T* gradient, T scale,
+		std::vector<uint>* embeddingRows = nullptr) const {
+		// Max pooling has no parameters, and passes dcda straight to its input
+		if (shape.kind == LayerKinds::maxPool) {
+			return;
+		}
 
-		// Apply backprop to each node
-		// All parameters have already been set
-		for (uint i = 0; i < nodes.size(); i++) {
-			nodes[i].backwardsPropogation();
+		// dC/dz = dC/da da/dz, stored over dadz
+		kernels::multiply(buffers.dadz, buffers.dcda, batch * NODECOUNT);
+
+		// Gradient of a convolution is summed over every window, from columns of forward propogation
+		const uint rows = getWeightRows(), columns = getWeightColumns();
+		if (shape.kind == LayerKinds::embedding && embeddingRows) {
+			kernels::embedGradientRows(
+				input, buffers.dadz, batch, INPUTSIZE, rows, columns, scale, gradient, gradient + rows * columns, *embeddingRows
+			);
+			return;
+		}
+		if (shape.kind == LayerKinds::embedding) {
+			kernels::embedGradient(input, buffers.dadz, batch, INPUTSIZE, rows, columns, scale, gradient, gradient + rows * columns);
+			return;
+		}
+		if (shape.kind == LayerKinds::convolution) {
+			input = buffers.scratch;
+			batch *= shape.getPositions();
 		}
+		kernels::gradient(input, buffers.dadz, batch, rows, columns, scale, gradient, gradient + rows * columns);
 
+		if (!mask.empty()) {
+			kernels::multiply(gradient, mask.data(), rows * columns);
+		}
 	}
 
-	// Returns activation from last forward pass
-	// For ith node in jth input
-	VMatrix<T> getActivation() {
-		return activation;
+	/* Applies backward propogation step
+	 * Sets gradient of this layer, averaged over each input set
+	 */
+	void propogateBackwards(const T* input, uint batch, const LayerBuffers<T>& buffers) {
+		rowsOnly = false;
+		propogateBackwards(input, batch, buffers, getGradient(), T(1) / T(batch));
+	}
+
+	/* Computes dCda for the previous layer (L-1)
+	 * Requires backward propogation of this layer
+	 * dcda is (batch, inputSize), each row an input, each column dcda for the ith node
+	 * A convolution reuses its columns for dcda of each window, so this must follow propogateBackwards
+	 */
+	void propogateInput(const LayerBuffers<T>& buffers, uint batch, T* dcda) const {
+		switch (shape.kind) {
+		case LayerKinds::convolution:
+			kernels::propogateInput(
+				buffers.dadz, getWeight().qGet(), batch * shape.getPositions(), shape.getPatchSize(), shape.filters,
+				buffers.scratch
+			);
+			kernels::col2im(buffers.scratch, batch, shape, dcda);
+			break;
+
+		case LayerKinds::maxPool:
+			kernels::maxPoolInput(buffers.dcda, buffers.scratch, batch, shape, dcda);
+			break;
+
+		case LayerKinds::embedding:
+			assert(false && "Category ids have no derivative, so an embedding must be the first layer");
+			break;
+
+		default:
+			kernels::propogateInput(buffers.dadz, getWeight().qGet(), batch, INPUTSIZE, NODECOUNT, dcda);
+			break;
+		}
+	}
+
+	/* Sets up state for an optimizer, all state starts at 0
+	 * Must be called before applyGradient with this optimizer
+	 */
+	void resetOptimizer(const Optimizer<T>& optimizer) {
+		rowsOnly = false;
+		const size_t length = getParameterCount();
+		storage.resize((2 + optimizer.getStateCount()) * length);
+		std::fill(storage.begin() + 2 * length, storage.end(), T(0));
+	}
+
+	/* Prunes weights at given indices of weight, setting them and their optimizer state to 0
+	 * Only dense layers are pruned, others share too few weights to gain from it
+	 */
+	void prune(const std::vector<uint>& indices) {
+		assert(isDense() && "Only dense layers can be pruned");
+
+		const uint length = getParameterCount();
+		if (mask.empty()) {
+			mask.assign((size_t)INPUTSIZE * NODECOUNT, T(1));
+		}
+		for (uint i : indices) {
+			mask[i] = T(0);
+			for (size_t a = 0; a < storage.size(); a += length) {
+				storage[a + i] = T(0);
+			}
+		}
+		compress();
+	}
+
+	/* Rebuilds compressed weight of a pruned layer from parameters
+	 * Must be called after parameters change for inference to see them
+	 * Only kept once at least half of weights are 0, below that the dense kernel is faster
+	 */
+	void compress() {
+		sparse.clear();
+		if (isPruned() && 2 * getPrunedCount() >= mask.size()) {
+			sparse.compress(getParameters(), INPUTSIZE, NODECOUNT);
+		}
+	}
+
+	// Returns true if any weight has been pruned
+	bool isPruned() const {
+		return !mask.empty();
+	}
+
+	// Returns number of weights pruned
+	uint getPrunedCount() const {
+		uint count = 0;
+		for (T m : mask) {
+			count += m == T(0) ? 1 : 0;
+		}
+		return count;
+	}
+
+	/* Updates parameters from gradient of last backward propogation
+	 * After setGradientRows, a stateless optimizer only steps those rows of weight and bias
+	 * which is the same as a full step, as the other rows have no gradient
+	 * Optimizers with state decay it on every step, so step all rows
+	 */
+	void applyGradient(const Optimizer<T>& optimizer) {
+		const uint length = getParameterCount();
+		if (!rowsOnly || optimizer.getStateCount()) {
+			optimizer.update(getParameters(), getGradient(), storage.data() + (size_t)2 * length, length);
+			return;
+		}
+
+		const uint columns = getWeightColumns();
+		for (uint r : gradientRows) {
+			optimizer.update(getParameters() + (size_t)r * columns, getGradient() + (size_t)r * columns, nullptr, columns);
+		}
+		const size_t bias = (size_t)getWeightRows() * columns;
+		optimizer.update(getParameters() + bias, getGradient() + bias, nullptr, columns);
+	}
+
+	// Sets gradient of all parameters from g, in the same layout as parameters
+	void setGradient(const T* g) {
+		alg::copy(g, getGradient(), getParameterCount());
+		rowsOnly = false;
+	}
+
+	/* Sets gradient of the given rows of weight and of bias from g, in the same layout as parameters
+	 * Other rows of weight are 0, and only these are stepped by applyGradient with a stateless optimizer
+	 */
+	void setGradientRows(const T* g, const std::vector<uint>& rows) {
+		const uint columns = getWeightColumns();
+
+		// Rows of the last gradient are cleared, so gradient stays whole for readers of all of it
+		if (rowsOnly) {
+			for (uint r : gradientRows) {
+				std::fill(getGradient() + (size_t)r * columns, getGradient() + (size_t)(r + 1) * columns, T(0));
+			}
+		}
+		else {
+			std::fill(getGradient(), getGradient() + (size_t)getWeightRows() * columns, T(0));
+		}
+
+		for (uint r : rows) {
+			alg::copy(g + (size_t)r * columns, getGradient() + (size_t)r * columns, columns);
+		}
+		const size_t bias = (size_t)getWeightRows() * columns;
+		alg::copy(g + bias, getGradient() + bias, columns);
+		gradientRows = rows;
+		rowsOnly = true;
+	}
+
+	// Selects kernels for the given accuracy of activation function
+	void setMathMode(MathMode mode) {
+		kernel = kernels::getKernelTable<T>(fusedOutput ? FunctionTypes::linear : activationFunctionType, mode);
+	}
+
+	// Sets if a loss applies the output function of this layer, with kernels of the given accuracy
+	void setFusedOutput(bool fused, MathMode mode) {
+		fusedOutput = fused;
+		setMathMode(mode);
+	}
+
+	// Returns weights, of size (inputSize, nodeCount), or (patchSize, filters) for a convolution
+	VMatrixView<T> getWeight() const {
+		return VMatrixView<T>(getParameters(), getWeightColumns(), getWeightRows());
+	}
+
+	// Returns bias, of size (1, nodeCount), or (1, filters) for a convolution
+	VMatrixView<T> getBias() const {
+		return VMatrixView<T>(getParameters() + getWeightRows() * getWeightColumns(), getWeightColumns(), 1);
+	}
+
+	// Returns number of rows of weight, inputs of each node or filter
+	uint getWeightRows() const {
+		switch (shape.kind) {
+		case LayerKinds::convolution:
+			return shape.getPatchSize();
+		case LayerKinds::maxPool:
+			return 0;
+		case LayerKinds::embedding:
+			return shape.vocabulary;
+		default:
+			return INPUTSIZE;
+		}
+	}
+
+	// Returns number of weights summed into each node, one row for each slot of an embedding, else rows of weight
+	uint getFanIn() const {
+		return shape.kind == LayerKinds::embedding ? INPUTSIZE : getWeightRows();
+	}
+
+	// Returns number of columns of weight, nodes or filters
+	uint getWeightColumns() const {
+		switch (shape.kind) {
+		case LayerKinds::convolution:
+			return shape.filters;
+		case LayerKinds::maxPool:
+			return 0;
+		default:
+			return NODECOUNT;
+		}
+	}
+
+	// Returns number of parameters, weights and bias
+	uint getParameterCount() const {
+		return (getWeightRows() + 1) * getWeightColumns();
+	}
+
+	// Returns length of scratch needed for a batch, 0 for a dense layer
+	size_t getScratchSize(uint batch) const {
+		switch (shape.kind) {
+		case LayerKinds::convolution:
+			return (size_t)batch * shape.getPositions() * shape.getPatchSize();
+		case LayerKinds::maxPool:
+			return (size_t)batch * NODECOUNT;
+		default:
+			return 0;
+		}
+	}
+
+	// Returns all parameters, weights followed by bias
+	T* getParameters() {
+		return storage.data();
+	}
+
+	const T* getParameters() const {
+		return storage.data();
+	}
+
+	// Returns gradient of all parameters, in the same layout as parameters
+	T* getGradient() {
+		return storage.data() + getParameterCount();
+	}
+
+	const T* getGradient() const {
+		return storage.data() + getParameterCount();
+	}
+
+	// Returns bytes used by parameters, gradient, optimizer state and pruning
+	size_t getParameterBytes() const {
+		return (storage.size() + mask.size()) * sizeof(T) + sparse.getBytes();
+	}
+
+	// Returns size of input to this layer
+	uint getInputSize() const {
+		return INPUTSIZE;
+	}
+
+	// Returns number of nodes in this layer
+	uint getNodeCount() const {
+		return NODECOUNT;
+	}
+
+	// Returns kind of layer and size of its image
+	const LayerShape& getShape() const {
+		return shape;
+	}
+
+	// Returns true if batch rows of input can be given to this layer, so ids of an embedding are inside its vocabulary
+	bool isValidInput(const T* input, uint batch) const {
+		return shape.kind != LayerKinds::embedding || kernels::validIds(input, (size_t)batch * INPUTSIZE, shape.vocabulary);
+	}
+
+	// Returns true for a dense layer, where each node takes all inputs
+	bool isDense() const {
+		return shape.kind == LayerKinds::dense;
+	}
+
+	// Returns activation function type for this layer
+	FunctionTypes getFunctionType() const {
+		return activationFunctionType;
 	}
 };
 
@@ -0,0 +1,252 @@
+/* Kernels that carry out the computation of a layer
+ * Operate on raw row major buffers, where each row is an input
+ */
+#ifndef __LAYER_KERNELS__
+#define __LAYER_KERNELS__
+
+#include "functions.hpp"
+#include "types.hpp"
+
+namespace kernels {
+	/* Applies activation policy Act to each value of z in place
+	 * z will be overwritten with the activation
+	 * and dadz with the derivative of the activation
+	 */
+	template <typename T, typename Act>
+	void activate(T* z, T* dadz, uint length) {
+		for (uint i = 0; i < length; i++) {
+			T x = z[i];
+			T a = Act::template function<T>(x);
+			dadz[i] = Act::template derivative<T>(x, a);
+			z[i] = a;
+		}
+	}
+
+	/* Applies activation policy Act to each value of z in place
+	 * Does not compute derivative, for use with inference
+	 */
+	template <typename T, typename Act>
+	void activate(T* z, uint length) {
+		for (uint i = 0; i < length; i++) {
+			z[i] = Act::template function<T>(z[i]);
+		}
+	}
+
+	/* Computes the linear combination z = XW + b
+	 * input is (batch, inputSize), weight is (inputSize, nodeCount)
+	 * bias is (1, nodeCount) and z is (batch, nodeCount)
+	 */
+	template <typename T>
+	void linear(const T* input, uint batch, uint inputSize,
+		const T* weight, const T* bias, uint nodeCount, T* z) {
+
+		for (uint j = 0; j < batch; j++) {
+			T* row = z + j * nodeCount;
+			const T* x = input + j * inputSize;
+
+			for (uint n = 0; n < nodeCount; n++) {
+				row[n] = bias[n];
+			}
+
+			// Accumulate each input across all nodes
+			// inner loop is contiguous in both row and weight
+			for (uint i = 0; i < inputSize; i++) {
+				const T xi = x[i];
+				const T* w = weight + i * nodeCount;
+				for (uint n = 0; n < nodeCount; n++) {
+					row[n] += xi * w[n];
+				}
+			}
+		}
+	}
+
+	/* Forward kernel for training
+	 * Computes activation and dadz for the given input
+	 */
+	template <typename T, typename Act>
+	void forward(const T* input, uint batch, uint inputSize,
+		const T* weight, const T* bias, uint nodeCount, T* activation, T* dadz) {
+
+		linear(input, batch, inputSize, weight, bias, nodeCount, activation);
+		activate<T, Act>(activation, dadz, batch * nodeCount);
+	}
+
+	/* Forward kernel for inference
+	 * Computes only activation
+	 */
+	template <typename T, typename Act>
+	void infer(const T* input, uint batch, uint inputSize,
+		const T* weight, const T* bias, uint nodeCount, T* activation) {
+
+		linear(input, batch, inputSize, weight, bias, nodeCount, activation);
+		activate<T, Act>(activation, batch * nodeCount);
+	}
+
+	/* Computes gradient of cost with respect to weight and bias
+	 * delta is dC/dz (batch, nodeCount), scale is applied to the sum over the batch
+	 * dWeight is (inputSize, nodeCount), dBias is (1, nodeCount)
+	 */
+	template <typename T>
+	void gradient(const T* input, const T* delta, uint batch, uint inputSize,
+		uint nodeCount, T scale, T* dWeight, T* dBias) {
+
+		for (uint i = 0; i < inputSize * nodeCount; i++) {
+			dWeight[i] = T(0);
+		}
+		for (uint n = 0; n < nodeCount; n++) {
+			dBias[n] = T(0);
+		}
+
+		for (uint j = 0; j < batch; j++) {
+			const T* x = input + j * inputSize;
+			const T* d = delta + j * nodeCount;
+
+			for (uint i = 0; i < inputSize; i++) {
+				const T xi = x[i];
+				T* w = dWeight + i * nodeCount;
+				for (uint n = 0; n < nodeCount; n++) {
+					w[n] += xi * d[n];
+				}
+			}
+
+			for (uint n = 0; n < nodeCount; n++) {
+				dBias[n] += d[n];
+			}
+		}
+
+		for (uint i = 0; i < inputSize * nodeCount; i++) {
+			dWeight[i] *= scale;
+		}
+		for (uint n = 0; n < nodeCount; n++) {
+			dBias[n] *= scale;
+		}
+	}
+
+	/* Propogates delta back through weight
+	 * Computes dC/da of the previous layer, dcda = delta W^T
+	 * dcda is (batch, inputSize)
+	 */
+	template <typename T>
+	void propogateInput(const T* delta, const T* weight, uint batch,
+		uint inputSize, uint nodeCount, T* dcda) {
+
+		for (uint j = 0; j < batch; j++) {
+			const T* d = delta + j * nodeCount;
+			T* out = dcda + j * inputSize;
+
+			for (uint i = 0; i < inputSize; i++) {
+				const T* w = weight + i * nodeCount;
+				T sum = T(0);
+				for (uint n = 0; n < nodeCount; n++) {
+					sum += d[n] * w[n];
+				}
+				out[i] = sum;
+			}
+		}
+	}
+
+	/* Computes dC/da of the output layer for squared error
+	 * dcda = 2(a - y) for vectors of given length
+	 */
+	template <typename T>
+	void costDerivative(const T* activation, const T* y, uint length, T* dcda) {
+		for (uint i = 0; i < length; i++) {
+			dcda[i] = T(2) * (activation[i] - y[i]);
+		}
+	}
+
+	/* Computes dC/da of the output layer along with squared error
+	 * in a single pass over the residual
+	 * returns cost, sum of (a - y)^2
+	 */
+	template <typename T>
+	T costAndDerivative(const T* activation, const T* y, uint length, T* dcda) {
+		T cost = T(0);
+		for (uint i = 0; i < length; i++) {
+			const T residual = activation[i] - y[i];
+			dcda[i] = T(2) * residual;
+			cost += residual * residual;
+		}
+		return cost;
+	}
+
+	// Computes y = y + kx for vectors of given length
+	template <typename T>
+	void axpy(T* y, const T* x, T k, uint length) {
+		for (uint i = 0; i < length; i++) {
+			y[i] += k * x[i];
+		}
+	}
+
+	// Computes a = a * b elementwise for vectors of given length
+	template <typename T>
+	void multiply(T* a, const T* b, uint length) {
+		for (uint i = 0; i < length; i++) {
+			a[i] *= b[i];
+		}
+	}
+
+	/* Table of kernels for a given activation
+	 * Resolved once when a layer is created, so the only
+	 * indirect call is per layer rather than per element
+	 */
+	template <typename T>
+	struct KernelTable {
+		using forward_ptr = void(*)(const T*, uint, uint, const T*, const T*, uint, T*, T*);
+		using infer_ptr = void(*)(const T*, uint, uint, const T*, const T*, uint, T*);
+
+		forward_ptr forward = nullptr;
+		infer_ptr infer = nullptr;
+
+		// Activation alone, for layers that compute z with their own kernels
+		using activate_ptr = void(*)(T*, T*, uint);
+		using apply_ptr = void(*)(T*, uint);
+
+		activate_ptr activate = nullptr;
+		apply_ptr apply = nullptr;
+	};
+
+	// Creates a kernel table for a given activation policy
+	template <typename T, typename Act>
+	KernelTable<T> makeKernelTable() {
+		KernelTable<T> table;
+		table.forward = forward<T, Act>;
+		table.infer = infer<T, Act>;
+		table.activate = activate<T, Act>;
+		table.apply = activate<T, Act>;
+		return table;
+	}
+
+	// Returns kernel table corresponding to function type
+	// Exp and log based functions use fast_math approximations on MathMode::fast
+	// where they are faster for T, otherwise libm is kept
+	template <typename T>
+	KernelTable<T> getKernelTable(FunctionTypes type, MathMode mode = MathMode::exact) {
+		const bool fast = mode == MathMode::fast && fast_math::IS_FASTER<T>;
+
+		switch (type) {
+		case FunctionTypes::sigmoid:
+			return fast ? makeKernelTable<T, activation::FastSigmoid>() : makeKernelTable<T, activation::Sigmoid>();
+
+		case FunctionTypes::ReLU:
+			return makeKernelTable<T, activation::ReLU>();
+
+		case FunctionTypes::LeakyReLU:
+			return makeKernelTable<T, activation::LeakyReLU>();
+
+		case FunctionTypes::softplus:
+			return fast ? makeKernelTable<T, activation::FastSoftplus>() : makeKernelTable<T, activation::Softplus>();
+
+		case FunctionTypes::tanH:
+			return fast ? makeKernelTable<T, activation::FastTanH>() : makeKernelTable<T, activation::TanH>();
+
+		case FunctionTypes::linear:
+			return makeKernelTable<T, activation::Linear>();
+
+		default:
+			return KernelTable<T>();
+		}
+	}
+}
+
+#endif
\ No newline at end of file
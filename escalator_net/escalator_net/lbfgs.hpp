@@ -0,0 +1,147 @@
+/* Limited memory BFGS
+ * Approximates the inverse hessian from the last few steps
+ * of parameters and gradient, all as flat vectors
+ */
+#ifndef __LBFGS__
+#define __LBFGS__
+
+#include <math.h>
+
+#include <vector>
+
+#include "layer_kernels.hpp"
+#include "types.hpp"
+
+namespace kernels {
+	// Computes dot product of vectors of given length
+	template <typename T>
+	T dot(const T* a, const T* b, uint length) {
+		T sum = T(0);
+		for (uint i = 0; i < length; i++) {
+			sum += a[i] * b[i];
+		}
+		return sum;
+	}
+}
+
+template <typename T>
+class LBFGS {
+	// Length of parameter vector
+	const uint LENGTH;
+
+	// Maximum number of steps remembered
+	const uint HISTORY;
+
+	// Change in parameters of each remembered step, one after the other
+	std::vector<T> s;
+
+	// Change in gradient of each remembered step
+	std::vector<T> y;
+
+	// 1 / (y.s) of each remembered step
+	std::vector<T> rho;
+
+	// Scratch for first loop of two loop recursion
+	std::vector<T> alpha;
+
+	// Number of steps remembered
+	uint stored = 0;
+
+	// Index the next step will be stored in
+	uint next = 0;
+
+	// Returns the i-th newest remembered step, 0 is newest
+	uint index(uint i) const {
+		return (next + HISTORY - 1 - i) % HISTORY;
+	}
+
+public:
+	// Maximum number of halvings of step in line search
+	static constexpr uint LINE_SEARCH_MAX = 40;
+
+	// Sufficient decrease constant of Armijo condition
+	static constexpr double ARMIJO = 1e-4;
+
+	// Relative fall in cost within LBFGS_STALL iterations for training to not have stalled
+	static constexpr double STALL_FALL = 0.01;
+
+	LBFGS(uint length, uint history)
+		: LENGTH(length), HISTORY(history ? history : 1),
+		s((size_t)length * HISTORY), y((size_t)length * HISTORY), rho(HISTORY), alpha(HISTORY) {
+	}
+
+	// Forgets all steps, next direction will be steepest descent
+	void clear() {
+		stored = 0;
+		next = 0;
+	}
+
+	// Returns number of steps remembered
+	uint size() const {
+		return stored;
+	}
+
+	/* Remembers a step, given change in parameters and change in gradient
+	 * Steps without positive curvature are skipped, as they would not
+	 * keep the approximation positive definite
+	 * returns true if the step was remembered
+	 */
+	bool update(const T* ds, const T* dy) {
+		const T ys = kernels::dot(dy, ds, LENGTH);
+		if (!(ys > T(1e-10) * kernels::dot(dy, dy, LENGTH))) {
+			return false;
+		}
+
+		T* sNext = s.data() + (size_t)next * LENGTH;
+		T* yNext = y.data() + (size_t)next * LENGTH;
+		for (uint i = 0; i < LENGTH; i++) {
+			sNext[i] = ds[i];
+			yNext[i] = dy[i];
+		}
+		rho[next] = T(1) / ys;
+
+		next = (next + 1) % HISTORY;
+		stored = stored < HISTORY ? stored + 1 : HISTORY;
+		return true;
+	}
+
+	/* Computes search direction d = -Hg with two loop recursion
+	 * Steepest descent if no steps are remembered
+	 */
+	void direction(const T* g, T* d) {
+		for (uint i = 0; i < LENGTH; i++) {
+			d[i] = g[i];
+		}
+
+		for (uint k = 0; k < stored; k++) {
+			const uint i = index(k);
+			const T* si = s.data() + (size_t)i * LENGTH;
+			const T* yi = y.data() + (size_t)i * LENGTH;
+			alpha[i] = rho[i] * kernels::dot(si, d, LENGTH);
+			kernels::axpy(d, yi, -alpha[i], LENGTH);
+		}
+
+		// Scale initial hessian by s.y / y.y of newest step
+		if (stored) {
+			const T* yi = y.data() + (size_t)index(0) * LENGTH;
+			const T gamma = T(1) / (rho[index(0)] * kernels::dot(yi, yi, LENGTH));
+			for (uint i = 0; i < LENGTH; i++) {
+				d[i] *= gamma;
+			}
+		}
+
+		for (uint k = stored; k--;) {
+			const uint i = index(k);
+			const T* si = s.data() + (size_t)i * LENGTH;
+			const T* yi = y.data() + (size_t)i * LENGTH;
+			const T beta = rho[i] * kernels::dot(yi, d, LENGTH);
+			kernels::axpy(d, si, alpha[i] - beta, LENGTH);
+		}
+
+		for (uint i = 0; i < LENGTH; i++) {
+			d[i] = -d[i];
+		}
+	}
+};
+
+#endif
\ No newline at end of file
@@ -57,9 +57,9 @@ struct LineTrialMaster {
 };
 
 
- /* implementation of an xor gate
+ /* Creates the examples of the line trial
 	  */
-void lt_trial() {
+LineTrialMaster lt_getMaster() {
 
 	LineTrialMaster master;
 	master.addLineTrial(
@@ -265,8 +265,15 @@ void lt_trial() {
 		1
 	);
 
+	return master;
+}
 
+ /* implementation of an xor gate
+	  */
+void lt_trial(uint batchSize = 0) {
+	LineTrialMaster master = lt_getMaster();
 	Network<double> net(16, FunctionTypes::sigmoid, { 4, 2 }, 1.0);
+	net.getHParams().set(BATCH_SIZE, batchSize);
 
 	VMatrix<double> input = master.getInput(16);
 	VMatrix<double> output = master.getOutput(2);
@@ -335,6 +342,10 @@ void runLineTrial() {
 	lt_trial();
 	std::cout << std::endl;
 
+	std::cout << "Line trial, batches of 8:" << std::endl;
+	lt_trial(8);
+	std::cout << std::endl;
+
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,192 @@
+/* Losses comparing output of a network to observations
+ * Cross entropy losses take the linear output z of the last layer
+ * and apply their own output function, sigmoid or softmax, fused with the cost
+ * so dC/dz is p - y without dividing by a saturated derivative
+ */
+#ifndef __LOSS__
+#define __LOSS__
+
+#include <math.h>
+
+#include <algorithm>
+#include <map>
+#include <string>
+
+#include "layer_kernels.hpp"
+#include "types.hpp"
+
+// Different types of loss, value is used in hyper parameters
+enum class LossTypes {
+	// Sum of (a - y)^2, through the activation of the output layer
+	squaredError = 0,
+	// Sum of binary cross entropy of sigmoid(z), each output independent
+	sigmoidCrossEntropy = 1,
+	// Sum of cross entropy of softmax(z) over each row, outputs are classes
+	softmaxCrossEntropy = 2,
+};
+
+// Map of LossTypes to string name
+const std::map<LossTypes, std::string> LOSS_TYPES_TO_NAME = {
+	{LossTypes::squaredError, "squared error"},
+	{LossTypes::sigmoidCrossEntropy, "sigmoid cross entropy"},
+	{LossTypes::softmaxCrossEntropy, "softmax cross entropy"}
+};
+
+namespace kernels {
+	/* Computes dC/dz of sigmoid cross entropy, and cost if evaluateCost
+	 * z is replaced with sigmoid(z), dcda is set to sigmoid(z) - y
+	 * cost is max(z, 0) - zy + log(1 + e^-|z|), which never overflows
+	 */
+	template <typename T>
+	T sigmoidCrossEntropy(T* z, const T* y, uint length, T* dcda, bool evaluateCost) {
+		T cost = T(0);
+		for (uint i = 0; i < length; i++) {
+			const T x = z[i];
+			const T e = exp(-fabs(x));
+			const T p = x >= T(0) ? T(1) / (T(1) + e) : e / (T(1) + e);
+			if (evaluateCost) {
+				cost += (std::max)(x, T(0)) - x * y[i] + log1p(e);
+			}
+			z[i] = p;
+			dcda[i] = p - y[i];
+		}
+		return cost;
+	}
+
+	/* Computes dC/dz of softmax cross entropy over each row, and cost if evaluateCost
+	 * z is (batch, n), and is replaced with softmax(z), dcda is set to softmax(z) - y
+	 * cost of a row is sum of y (lse - z), where lse is log sum exp of z
+	 * taken about the row maximum so exp never overflows
+	 */
+	template <typename T>
+	T softmaxCrossEntropy(T* z, const T* y, uint batch, uint n, T* dcda, bool evaluateCost) {
+		T cost = T(0);
+		for (uint j = 0; j < batch; j++) {
+			T* row = z + j * n;
+			const T* yRow = y + j * n;
+			T* dRow = dcda + j * n;
+
+			const T m = *std::max_element(row, row + n);
+			T sum = T(0);
+			for (uint k = 0; k < n; k++) {
+				sum += exp(row[k] - m);
+			}
+			const T lse = m + log(sum);
+
+			for (uint k = 0; k < n; k++) {
+				if (evaluateCost) {
+					cost += yRow[k] * (lse - row[k]);
+				}
+				const T p = exp(row[k] - lse);
+				row[k] = p;
+				dRow[k] = p - yRow[k];
+			}
+		}
+		return cost;
+	}
+
+	// Replaces z with sigmoid(z)
+	template <typename T>
+	void sigmoidOutput(T* z, uint length) {
+		for (uint i = 0; i < length; i++) {
+			z[i] = T(1) / (T(1) + exp(-z[i]));
+		}
+	}
+
+	// Replaces each row of z, of size (batch, n), with softmax of the row
+	template <typename T>
+	void softmaxOutput(T* z, uint batch, uint n) {
+		for (uint j = 0; j < batch; j++) {
+			T* row = z + j * n;
+			const T m = *std::max_element(row, row + n);
+			T sum = T(0);
+			for (uint k = 0; k < n; k++) {
+				row[k] = exp(row[k] - m);
+				sum += row[k];
+			}
+			for (uint k = 0; k < n; k++) {
+				row[k] /= sum;
+			}
+		}
+	}
+}
+
+namespace loss {
+	// Returns true if loss applies its own output function to the last layer
+	inline bool isCrossEntropy(LossTypes type) {
+		return type != LossTypes::squaredError;
+	}
+
+	/* Applies output function of loss to z of size (batch, n) in place
+	 * Squared error leaves output unchanged
+	 */
+	template <typename T>
+	void applyOutput(LossTypes type, T* z, uint batch, uint n) {
+		switch (type) {
+		case LossTypes::sigmoidCrossEntropy:
+			kernels::sigmoidOutput(z, batch * n);
+			break;
+
+		case LossTypes::softmaxCrossEntropy:
+			kernels::softmaxOutput(z, batch, n);
+			break;
+
+		default:
+			break;
+		}
+	}
+
+	/* Sets dcda of the output layer, of size (batch, n), from output and observations y
+	 * returns cost if evaluateCost, otherwise 0
+	 * Cross entropy losses take z, and replace it with their output, dcda is then dC/dz
+	 */
+	template <typename T>
+	T costAndDerivative(LossTypes type, T* output, const T* y, uint batch, uint n, T* dcda, bool evaluateCost) {
+		switch (type) {
+		case LossTypes::sigmoidCrossEntropy:
+			return kernels::sigmoidCrossEntropy(output, y, batch * n, dcda, evaluateCost);
+
+		case LossTypes::softmaxCrossEntropy:
+			return kernels::softmaxCrossEntropy(output, y, batch, n, dcda, evaluateCost);
+
+		default:
+			if (evaluateCost) {
+				return kernels::costAndDerivative(output, y, batch * n, dcda);
+			}
+			kernels::costDerivative(output, y, batch * n, dcda);
+			return T(0);
+		}
+	}
+
+	/* As costAndDerivative, with an optional weight for each row, and optional cost of each row
+	 * Cost and dcda of row j are multiplied by weights[j], rowCosts[j] is set to the cost before weighting
+	 */
+	template <typename T>
+	T weightedCostAndDerivative(LossTypes type, T* output, const T* y, uint batch, uint n, T* dcda, bool evaluateCost,
+		const T* weights, T* rowCosts) {
+
+		if (!weights && !rowCosts) {
+			return costAndDerivative(type, output, y, batch, n, dcda, evaluateCost);
+		}
+
+		T cost = T(0);
+		for (uint j = 0; j < batch; j++) {
+			T* d = dcda + j * n;
+			const T c = costAndDerivative(type, output + j * n, y + j * n, 1, n, d, evaluateCost || rowCosts);
+			if (rowCosts) {
+				rowCosts[j] = c;
+			}
+
+			const T w = weights ? weights[j] : T(1);
+			if (weights) {
+				for (uint k = 0; k < n; k++) {
+					d[k] *= w;
+				}
+			}
+			cost += w * c;
+		}
+		return evaluateCost ? cost : T(0);
+	}
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,191 @@
+/* Benchmark of losses
+ * Compares squared error against cross entropy on binary and multi class problems
+ * by iterations, and by accuracy of the trained network */
+#ifndef __LOSS_BENCHMARK__
+#define __LOSS_BENCHMARK__
+
+#include <math.h>
+
+#include <iomanip>
+#include <iostream>
+
+#include "network.hpp"
+#include "static_network.hpp"
+
+namespace tests {
+	// Seeds trained for each loss on the binary problem
+	const uint LB_SEEDS = 8;
+
+	// Size of generated multi class set
+	const uint LB_EXAMPLES = 512;
+	const uint LB_CLASSES = 3;
+
+	// Iterations of each run on the multi class set
+	const uint LB_ITERATIONS = 2000;
+
+	// Returns largest difference between prediction and output
+	double lb_maxError(const Network<double>& net, const VMatrix<double>& input, const VMatrix<double>& output) {
+		VMatrix<double> prediction = net.makePrediction(input);
+		double error = 0.0;
+		for (uint i = 0; i < output.getLength(); i++) {
+			error = (std::max)(error, std::abs(prediction.qGet(i) - output.qGet(i)));
+		}
+		return error;
+	}
+
+	// Returns fraction of rows where the largest prediction is the observed class
+	double lb_accuracy(const Network<double>& net, const VMatrix<double>& input, const VMatrix<double>& output) {
+		VMatrix<double> prediction = net.makePrediction(input);
+		const uint n = output.getRowLength();
+		uint correct = 0;
+		for (uint j = 0; j < output.getColumnLength(); j++) {
+			const double* p = prediction.qGet() + j * n;
+			const double* y = output.qGet() + j * n;
+			correct += std::max_element(p, p + n) - p == std::max_element(y, y + n) - y;
+		}
+		return (double)correct / output.getColumnLength();
+	}
+
+	/* Generates the multi class set
+	 * Inputs are points in [-1, 1]^2, class is which third of the circle the point is in
+	 */
+	void lb_generate(VMatrix<double>& input, VMatrix<double>& output) {
+		const double PI = 3.14159265358979323846;
+		input.qFill(2, LB_EXAMPLES, 0.0);
+		output.qFill(LB_CLASSES, LB_EXAMPLES, 0.0);
+		rand_ex::seed(1);
+		rand_ex::sampleNextUniforms(input.qGet(), input.getLength(), -1.0, 1.0);
+		rand_ex::reset();
+		for (uint j = 0; j < LB_EXAMPLES; j++) {
+			const double angle = atan2(input.get(1, j), input.get(0, j)) + PI;
+			const uint c = (std::min)((uint)(angle / (2.0 * PI) * LB_CLASSES), LB_CLASSES - 1);
+			output.set(c, j, 1.0);
+		}
+	}
+
+	/* Trains the deep XOR gate from each seed with a loss
+	 * and prints number converged, mean iterations and worst error
+	 */
+	void lb_binary(LossTypes type, const VMatrix<double>& input, const VMatrix<double>& output) {
+		uint converged = 0;
+		double iterations = 0.0, error = 0.0;
+		for (uint seed = 0; seed < LB_SEEDS; seed++) {
+			rand_ex::seed(seed);
+			Network<double> net(2, FunctionTypes::sigmoid, { 2, 2, 1 }, 1.0);
+			net.getHParams().set(LOSS, (double)type);
+			net.getHParams().set(ITERATION_MAX, 100000.0);
+
+			net.addExample(input, output);
+			net.train();
+
+			if (net.isConverged()) {
+				converged++;
+				iterations += net.getIterations();
+				error = (std::max)(error, lb_maxError(net, input, output));
+			}
+		}
+		rand_ex::reset();
+
+		std::cout << "  " << std::setw(22) << std::left << LOSS_TYPES_TO_NAME.at(type)
+			<< converged << "/" << LB_SEEDS << " converged";
+		if (converged) {
+			std::cout << ", mean " << iterations / converged << " iterations, worst error " << error;
+		}
+		std::cout << std::endl;
+	}
+
+	/* Trains on the multi class set for a fixed number of iterations
+	 * and prints accuracy
+	 */
+	void lb_multiClass(LossTypes type, double learningRate, const VMatrix<double>& input, const VMatrix<double>& output) {
+		rand_ex::reset();
+		Network<double> net(2, FunctionTypes::tanH, { 8, LB_CLASSES }, learningRate);
+		net.initialise(InitialisationTypes::xavier);
+		net.getHParams().set(LOSS, (double)type);
+		net.getHParams().set(ITERATION_MAX, LB_ITERATIONS);
+		net.getHParams().set(CONVERGENCE_THRESHOLD, 0.0);
+
+		net.addExample(input, output);
+		net.train();
+
+		std::cout << "  " << std::setw(22) << std::left << LOSS_TYPES_TO_NAME.at(type)
+			<< "accuracy " << lb_accuracy(net, input, output) << " in " << net.getExecutionTime() << "s" << std::endl;
+	}
+
+	/* Trains with softmax cross entropy, then changes loss back to squared error
+	 * The output layer keeps its own activation, so a StaticNetwork of it
+	 * is refused while the loss applies softmax, and predicts the same once it does not
+	 */
+	void lb_switchLoss(const VMatrix<double>& input, const VMatrix<double>& output) {
+		rand_ex::reset();
+		Network<double> net(2, FunctionTypes::tanH, { 8, LB_CLASSES }, 0.5);
+		net.initialise(InitialisationTypes::xavier);
+		net.getHParams().set(LOSS, (double)LossTypes::softmaxCrossEntropy);
+		net.getHParams().set(ITERATION_MAX, 100.0);
+		net.getHParams().set(CONVERGENCE_THRESHOLD, 0.0);
+
+		net.addExample(input, output);
+		net.train();
+
+		StaticNetwork<double, activation::TanH, 2, 8, LB_CLASSES> fixed;
+		const bool loadedFused = fixed.load(net);
+
+		net.getHParams().set(LOSS, (double)LossTypes::squaredError);
+		const bool loaded = fixed.load(net);
+
+		VMatrix<double> prediction = net.makePrediction(input);
+		double difference = 0.0;
+		for (uint j = 0; j < input.getColumnLength(); j++) {
+			Matrix<2, 1, double> x(0.0);
+			alg::copy(input.qGet() + j * 2, x.qGet(), 2);
+			Matrix<LB_CLASSES, 1, double> y = fixed.predict(x);
+			for (uint k = 0; k < LB_CLASSES; k++) {
+				difference = (std::max)(difference, std::abs(y.qGet(k) - prediction.qGet()[j * LB_CLASSES + k]));
+			}
+		}
+
+		std::cout << "  output layer " << Functions<double>::getFunctionName(net.getLayer(1).getFunctionType())
+			<< ", static load with softmax " << (loadedFused ? "accepted" : "refused")
+			<< ", with squared error " << (loaded ? "accepted" : "refused")
+			<< ", largest difference " << difference << std::endl;
+	}
+
+	/* Runs all benchmarks
+	 */
+	void runLossBenchmark() {
+		VMatrix<double> input(
+			{
+				{0.0, 0.0},
+				{0.0, 1.0},
+				{1.0, 0.0},
+				{1.0, 1.0}
+			}
+		);
+
+		VMatrix<double> output(
+			{
+				{0.0},
+				{1.0},
+				{1.0},
+				{0.0}
+			}
+		);
+
+		std::cout << "XOR Deep Gate:" << std::endl;
+		lb_binary(LossTypes::squaredError, input, output);
+		lb_binary(LossTypes::sigmoidCrossEntropy, input, output);
+
+		VMatrix<double> classInput(1, 1, 0.0), classOutput(1, 1, 0.0);
+		lb_generate(classInput, classOutput);
+
+		std::cout << "Three classes, " << LB_ITERATIONS << " iterations:" << std::endl;
+		lb_multiClass(LossTypes::squaredError, 0.5, classInput, classOutput);
+		lb_multiClass(LossTypes::sigmoidCrossEntropy, 0.5, classInput, classOutput);
+		lb_multiClass(LossTypes::softmaxCrossEntropy, 0.5, classInput, classOutput);
+
+		std::cout << "Changing loss after training:" << std::endl;
+		lb_switchLoss(classInput, classOutput);
+	}
+}
+
+#endif
\ No newline at end of file
@@ -94,6 +94,81 @@ public:
 		}
 	}
 
+	// gets data directly
+	T* qGet() {
+		return data;
+	}
+
+	// gets data directly
+	const T* qGet() const {
+		return data;
+	}
+
+	// Fast get, will return the ith component in internal array
+	T qGet(uint i) const {
+		assert(i < LENGTH && "Attempt to qGet outside of possible range");
+		return data[i];
+	}
+
+	// Conducts Matrix element wise addition
+	Matrix operator+(const Matrix& b) const {
+		Matrix c(*this);
+		alg::unroll<LENGTH>([&](uint i) { c.data[i] += b.data[i]; });
+		return c;
+	}
+
+	// Conducts Matrix element wise substraction
+	Matrix operator-(const Matrix& b) const {
+		Matrix c(*this);
+		alg::unroll<LENGTH>([&](uint i) { c.data[i] -= b.data[i]; });
+		return c;
+	}
+
+	// Conducts Matrix scalar multiplication in the form Ak
+	Matrix operator*(const T& k) const {
+		Matrix c(*this);
+		alg::unroll<LENGTH>([&](uint i) { c.data[i] *= k; });
+		return c;
+	}
+
+	/* Conducts Matrix matrix multiplication in the form AB
+	 * Dimensions are checked at compile time, and loops fully unrolled
+	 * So is only suitable for small matrices
+	 */
+	template <uint R2>
+	Matrix<R2, C, T> operator*(const Matrix<R2, R, T>& b) const {
+		Matrix<R2, C, T> c(T(0));
+		T* out = c.qGet();
+		const T* in = b.qGet();
+
+		alg::unroll<C>([&](uint j) {
+			alg::unroll<R>([&](uint p) {
+				const T a = data[j * R + p];
+				alg::unroll<R2>([&](uint i) {
+					out[j * R2 + i] += a * in[p * R2 + i];
+				});
+			});
+		});
+
+		return c;
+	}
+
+	// Conducts Matrix elementwise multiplication
+	Matrix elementMultiply(const Matrix& b) const {
+		Matrix c(*this);
+		alg::unroll<LENGTH>([&](uint i) { c.data[i] *= b.data[i]; });
+		return c;
+	}
+
+	// Applies F to each element, F : T -> T
+	// F is a template parameter, so can be inlined
+	template <typename F>
+	Matrix apply(F func) const {
+		Matrix c(*this);
+		alg::unroll<LENGTH>([&](uint i) { c.data[i] = func(c.data[i]); });
+		return c;
+	}
+
 };
 
 #endif
\ No newline at end of file
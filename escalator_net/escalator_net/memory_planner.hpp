@@ -0,0 +1,208 @@
+/* Plans memory for buffers used in an iteration of training
+ * Each buffer is live over a range of steps, and buffers
+ * that are never live at the same time share memory in a single pool
+ */
+#ifndef __MEMORY_PLANNER__
+#define __MEMORY_PLANNER__
+
+#include <assert.h>
+
+#include <algorithm>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "types.hpp"
+
+// Size of a cache line in bytes
+const size_t CACHE_LINE = 64;
+
+/* Allocator that starts and ends each allocation on a cache line
+ * so buffers used by different threads never share a line
+ */
+template <typename T>
+struct CacheAllocator {
+	using value_type = T;
+
+	CacheAllocator() {
+	}
+
+	template <typename U>
+	CacheAllocator(const CacheAllocator<U>&) {
+	}
+
+	T* allocate(size_t n) {
+		const size_t bytes = (n * sizeof(T) + CACHE_LINE - 1) / CACHE_LINE * CACHE_LINE;
+		return (T*)::operator new(bytes, std::align_val_t(CACHE_LINE));
+	}
+
+	void deallocate(T* p, size_t) {
+		::operator delete(p, std::align_val_t(CACHE_LINE));
+	}
+
+	template <typename U>
+	bool operator==(const CacheAllocator<U>&) const {
+		return true;
+	}
+
+	template <typename U>
+	bool operator!=(const CacheAllocator<U>&) const {
+		return false;
+	}
+};
+
+template <typename T>
+class MemoryPlan {
+public:
+	/* A buffer requested from the plan
+	 * Is live from step first to step last, inclusive
+	 */
+	struct Buffer {
+		std::string name;
+		uint layer;
+		size_t length;
+		uint first;
+		uint last;
+
+		// Offset in pool, set on plan()
+		size_t offset = 0;
+
+		// True if both buffers are live on some step
+		bool overlaps(const Buffer& b) const {
+			return first <= b.last && b.first <= last;
+		}
+	};
+
+private:
+	// Buffers are aligned to cache lines
+	static constexpr size_t ALIGNMENT = CACHE_LINE / sizeof(T) ? CACHE_LINE / sizeof(T) : 1;
+
+	// Requested buffers
+	std::vector<Buffer> buffers;
+
+	// Pool that all buffers are placed in
+	std::vector<T, CacheAllocator<T>> pool;
+
+	// Rounds length up to alignment
+	static size_t align(size_t length) {
+		return (length + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+	}
+
+public:
+	// Removes all buffers and frees pool
+	void clear() {
+		buffers.clear();
+		pool.clear();
+		pool.shrink_to_fit();
+	}
+
+	/* Requests a buffer of given length
+	 * Which is live from step first to last
+	 * returns id of buffer for use with get
+	 */
+	uint request(std::string name, uint layer, size_t length, uint first, uint last) {
+		assert(first <= last && "Buffer must be live for at least one step");
+		Buffer buffer;
+		buffer.name = name;
+		buffer.layer = layer;
+		buffer.length = length;
+		buffer.first = first;
+		buffer.last = last;
+		buffers.push_back(buffer);
+		return (uint)buffers.size() - 1;
+	}
+
+	/* Places each buffer in the pool, then allocates pool
+	 * Largest buffers are placed first, each at the lowest offset
+	 * which does not collide with a placed buffer live at the same time
+	 */
+	void plan() {
+		std::vector<uint> order(buffers.size());
+		for (uint i = 0; i < order.size(); i++) {
+			order[i] = i;
+		}
+		std::stable_sort(order.begin(), order.end(),
+			[this](uint a, uint b) {
+				return buffers[a].length > buffers[b].length;
+			}
+		);
+
+		size_t poolLength = 0;
+		std::vector<uint> placed;
+
+		for (uint i : order) {
+			Buffer& buffer = buffers[i];
+
+			// Regions taken by live buffers, sorted by offset
+			std::vector<std::pair<size_t, size_t>> taken;
+			for (uint j : placed) {
+				if (buffers[j].overlaps(buffer)) {
+					taken.push_back({ buffers[j].offset, buffers[j].offset + align(buffers[j].length) });
+				}
+			}
+			std::sort(taken.begin(), taken.end());
+
+			// First gap that fits
+			size_t offset = 0;
+			for (auto& region : taken) {
+				if (offset + align(buffer.length) <= region.first) {
+					break;
+				}
+				offset = (std::max)(offset, region.second);
+			}
+
+			buffer.offset = offset;
+			poolLength = (std::max)(poolLength, offset + align(buffer.length));
+			placed.push_back(i);
+		}
+
+		pool.assign(poolLength, T(0));
+	}
+
+	// Returns pointer to the buffer with given id
+	T* get(uint id) {
+		return pool.data() + buffers[id].offset;
+	}
+
+	// Returns requested buffers
+	const std::vector<Buffer>& getBuffers() const {
+		return buffers;
+	}
+
+	// Returns size of pool, which is the peak memory of an iteration
+	size_t getPoolBytes() const {
+		return pool.size() * sizeof(T);
+	}
+
+	// Returns memory that would be used if no buffers were shared
+	size_t getUnsharedBytes() const {
+		size_t total = 0;
+		for (auto& buffer : buffers) {
+			total += buffer.length * sizeof(T);
+		}
+		return total;
+	}
+
+	// Returns memory of all buffers for a layer
+	size_t getLayerBytes(uint layer) const {
+		size_t total = 0;
+		for (auto& buffer : buffers) {
+			total += buffer.layer == layer ? buffer.length * sizeof(T) : 0;
+		}
+		return total;
+	}
+
+	// Returns a description of each buffer
+	std::string report() const {
+		std::stringstream ss;
+		for (auto& buffer : buffers) {
+			ss << "  Layer " << buffer.layer << " " << buffer.name << ": "
+				<< buffer.length * sizeof(T) << " bytes, live steps "
+				<< buffer.first << "-" << buffer.last << ", offset " << buffer.offset * sizeof(T) << std::endl;
+		}
+		return ss.str();
+	}
+};
+
+#endif
\ No newline at end of file
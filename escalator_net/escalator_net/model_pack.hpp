@@ -0,0 +1,460 @@
+/* Trains many small networks of the same shape at once
+ * Models are interleaved, so every parameter, activation and example value
+ * is stored LANES times in a row, once for each model in a group
+ * Each loop over a group then runs over lanes innermost, which auto vectorises
+ * so a vector unit steps LANES models at once, however small each model is
+ */
+#ifndef __MODEL_PACK__
+#define __MODEL_PACK__
+
+#include <algorithm>
+#include <vector>
+
+#include "network.hpp"
+
+/* A pack of models with layer sizes sizes, the first being the width of input
+ * Act is an activation policy from functions.hpp, used by all layers
+ * Trains full batch with SGD and squared error, as Network does by default
+ * Each model stops updating once its own cost falls below CONVERGENCE_THRESHOLD
+ */
+template <typename T, typename Act, uint LANES = 8>
+class ModelPack {
+	// Width of input, then nodes of each layer
+	std::vector<uint> sizes;
+
+	// Number of models, the last group is padded with models that never train
+	uint modelCount;
+	uint groupCount;
+
+	// Parameters of a single model, and offset of each layer in them
+	uint parameterCount = 0;
+	std::vector<uint> offsets;
+
+	// Hyper parameters for optimisation
+	HyperParameters hParams;
+
+	/* Parameters of all models in the layout of Layer, interleaved
+	 * Parameter p of model m is at ((m / LANES) * parameterCount + p) * LANES + m % LANES
+	 */
+	std::vector<T> parameters;
+
+	/* Examples of all models, interleaved in the same way
+	 * Value i of example e of model m is at (((m / LANES) * exampleCount + e) * width + i) * LANES + m % LANES
+	 */
+	std::vector<T> input;
+	std::vector<T> output;
+	uint exampleCount = 0;
+
+	// Results of last training of each model
+	std::vector<T> costs;
+	std::vector<uint> iterations;
+	std::vector<bool> converged;
+
+	// time taken by last training
+	double executionTime = 0.0;
+
+	// Buffers of a group for an iteration, activation, dadz and dcda of each layer over all examples
+	struct Buffers {
+		std::vector<std::vector<T>> activation, dadz, dcda;
+		std::vector<T> gradient;
+	};
+
+	// Returns the parameter of a model at index p
+	T& at(uint model, uint p) {
+		return parameters[((size_t)(model / LANES) * parameterCount + p) * LANES + model % LANES];
+	}
+
+	const T& at(uint model, uint p) const {
+		return parameters[((size_t)(model / LANES) * parameterCount + p) * LANES + model % LANES];
+	}
+
+	// Sizes buffers for a batch of given size
+	void prepare(Buffers& buffers, uint batch) const {
+		const uint L = (uint)sizes.size() - 1;
+		buffers.activation.resize(L);
+		buffers.dadz.resize(L);
+		buffers.dcda.resize(L);
+		for (uint l = 0; l < L; l++) {
+			const size_t length = (size_t)batch * sizes[l + 1] * LANES;
+			buffers.activation[l].resize(length);
+			buffers.dadz[l].resize(length);
+			buffers.dcda[l].resize(length);
+		}
+		buffers.gradient.resize((size_t)parameterCount * LANES);
+	}
+
+	/* Forward propogates a batch of interleaved input through a group of interleaved parameters
+	 * Sets activation and dadz of each layer in buffers
+	 */
+	void propogateForward(const T* group, const T* x, uint batch, Buffers& buffers) const {
+		for (uint l = 0; l + 1 < sizes.size(); l++) {
+			const uint in = sizes[l], out = sizes[l + 1];
+			const T* w = group + (size_t)offsets[l] * LANES;
+			const T* b = w + (size_t)in * out * LANES;
+			const T* prev = l ? buffers.activation[l - 1].data() : x;
+			T* a = buffers.activation[l].data();
+			T* dadz = buffers.dadz[l].data();
+
+			for (uint e = 0; e < batch; e++) {
+				const T* xe = prev + (size_t)e * in * LANES;
+				T* z = a + (size_t)e * out * LANES;
+
+				std::copy(b, b + out * LANES, z);
+				for (uint i = 0; i < in; i++) {
+					const T* wi = w + (size_t)i * out * LANES;
+					for (uint n = 0; n < out; n++) {
+						for (uint k = 0; k < LANES; k++) {
+							z[n * LANES + k] += xe[i * LANES + k] * wi[n * LANES + k];
+						}
+					}
+				}
+			}
+
+			const size_t length = (size_t)batch * out * LANES;
+			for (size_t j = 0; j < length; j++) {
+				const T zj = a[j];
+				a[j] = Act::template function<T>(zj);
+				dadz[j] = Act::template derivative<T>(zj, a[j]);
+			}
+		}
+	}
+
+	/* Backward propogates through a group, after forward propogation of x
+	 * Sets gradient of each model in buffers, averaged over batch
+	 * Adds squared error of each model over y to cost
+	 */
+	void propogateBackward(const T* group, const T* x, const T* y, uint batch, Buffers& buffers, T* cost) const {
+		const uint L = (uint)sizes.size() - 1;
+		const T scale = T(1) / T(batch);
+
+		// dcda of output layer
+		{
+			const T* a = buffers.activation[L - 1].data();
+			T* dcda = buffers.dcda[L - 1].data();
+			const size_t rows = (size_t)batch * sizes[L];
+			for (size_t j = 0; j < rows; j++) {
+				for (uint k = 0; k < LANES; k++) {
+					const T residual = a[j * LANES + k] - y[j * LANES + k];
+					dcda[j * LANES + k] = T(2) * residual;
+					cost[k] += residual * residual;
+				}
+			}
+		}
+
+		std::fill(buffers.gradient.begin(), buffers.gradient.end(), T(0));
+
+		for (uint l = L; l--;) {
+			const uint in = sizes[l], out = sizes[l + 1];
+			const T* w = group + (size_t)offsets[l] * LANES;
+			T* gw = buffers.gradient.data() + (size_t)offsets[l] * LANES;
+			T* gb = gw + (size_t)in * out * LANES;
+			const T* prev = l ? buffers.activation[l - 1].data() : x;
+
+			// dC/dz = dC/da da/dz, stored over dadz
+			T* dz = buffers.dadz[l].data();
+			const T* dcda = buffers.dcda[l].data();
+			const size_t length = (size_t)batch * out * LANES;
+			for (size_t j = 0; j < length; j++) {
+				dz[j] *= dcda[j];
+			}
+
+			for (uint e = 0; e < batch; e++) {
+				const T* xe = prev + (size_t)e * in * LANES;
+				const T* dze = dz + (size_t)e * out * LANES;
+
+				for (uint i = 0; i < in; i++) {
+					T* gwi = gw + (size_t)i * out * LANES;
+					for (uint n = 0; n < out; n++) {
+						for (uint k = 0; k < LANES; k++) {
+							gwi[n * LANES + k] += scale * xe[i * LANES + k] * dze[n * LANES + k];
+						}
+					}
+				}
+				for (uint j = 0; j < out * LANES; j++) {
+					gb[j] += scale * dze[j];
+				}
+			}
+
+			// dcda of previous layer
+			if (l) {
+				T* dcdaPrev = buffers.dcda[l - 1].data();
+				for (uint e = 0; e < batch; e++) {
+					const T* dze = dz + (size_t)e * out * LANES;
+					T* de = dcdaPrev + (size_t)e * in * LANES;
+					for (uint i = 0; i < in; i++) {
+						const T* wi = w + (size_t)i * out * LANES;
+						T* dei = de + (size_t)i * LANES;
+						std::fill(dei, dei + LANES, T(0));
+						for (uint n = 0; n < out; n++) {
+							for (uint k = 0; k < LANES; k++) {
+								dei[k] += wi[n * LANES + k] * dze[n * LANES + k];
+							}
+						}
+					}
+				}
+			}
+		}
+	}
+
+	// Returns true if lane k of group g holds a model
+	bool isModel(uint g, uint k) const {
+		return g * LANES + k < modelCount;
+	}
+
+	/* Copies parameters and examples of a model into lane k of a working group
+	 * or back out of the lane if leaving
+	 */
+	void moveLane(uint model, uint k, T* group, T* x, T* y, bool leaving) {
+		const uint g = model / LANES, lane = model % LANES;
+		for (uint p = 0; p < parameterCount; p++) {
+			T& stored = at(model, p);
+			T& working = group[(size_t)p * LANES + k];
+			(leaving ? stored : working) = leaving ? working : stored;
+		}
+		if (leaving) {
+			return;
+		}
+
+		const size_t inLength = (size_t)exampleCount * sizes.front(), outLength = (size_t)exampleCount * sizes.back();
+		for (size_t i = 0; i < inLength; i++) {
+			x[i * LANES + k] = input[(g * inLength + i) * LANES + lane];
+		}
+		for (size_t i = 0; i < outLength; i++) {
+			y[i * LANES + k] = output[(g * outLength + i) * LANES + lane];
+		}
+	}
+
+public:
+	// Creates a pack of modelCount models, with weights from U(0, 1) as Layer, and bias of 0
+	ModelPack(std::vector<uint> sizes, uint modelCount)
+		: sizes(sizes), modelCount(modelCount), groupCount((modelCount + LANES - 1) / LANES) {
+
+		for (uint l = 0; l + 1 < sizes.size(); l++) {
+			offsets.push_back(parameterCount);
+			parameterCount += (sizes[l] + 1) * sizes[l + 1];
+		}
+
+		parameters.assign((size_t)groupCount * parameterCount * LANES, T(0));
+		for (uint m = 0; m < modelCount; m++) {
+			initialise(m, InitialisationTypes::uniform);
+		}
+
+		costs.assign(modelCount, T(0));
+		iterations.assign(modelCount, 0);
+		converged.assign(modelCount, false);
+	}
+
+	// Get a reference to internal hyper parameters
+	HyperParameters& getHParams() {
+		return hParams;
+	}
+
+	// Returns number of models
+	uint getModelCount() const {
+		return modelCount;
+	}
+
+	// Randomises weights of a model with given scheme, and sets its bias to 0
+	void initialise(uint model, InitialisationTypes type) {
+		std::vector<T> weight;
+		for (uint l = 0; l + 1 < sizes.size(); l++) {
+			const uint in = sizes[l], out = sizes[l + 1];
+			weight.resize((size_t)in * out);
+			initialisation::fillWeights(weight.data(), in, out, Act::TYPE, type);
+			for (uint p = 0; p < in * out; p++) {
+				at(model, offsets[l] + p) = weight[p];
+			}
+			for (uint p = in * out; p < (in + 1) * out; p++) {
+				at(model, offsets[l] + p) = T(0);
+			}
+		}
+	}
+
+	// Copies parameters of a network into a model
+	// Returns false if network is not of the same shape and activation, normalises its input
+	// or has a cross entropy loss, as its output function is applied by the loss
+	bool load(uint model, const Network<T>& network) {
+		if (network.getLayerCount() + 1 != sizes.size() || network.isNormalised() || loss::isCrossEntropy(network.getLoss())) {
+			return false;
+		}
+		for (uint l = 0; l < network.getLayerCount(); l++) {
+			const Layer<T>& layer = network.getLayer(l);
+			if (!layer.isDense() || layer.getInputSize() != sizes[l] || layer.getNodeCount() != sizes[l + 1]
+				|| layer.getFunctionType() != Act::TYPE) {
+				return false;
+			}
+		}
+
+		std::vector<T> x(parameterCount);
+		network.getParameters(x.data());
+		for (uint p = 0; p < parameterCount; p++) {
+			at(model, p) = x[p];
+		}
+		return true;
+	}
+
+	// Copies parameters of a model into a network of the same shape
+	void store(uint model, Network<T>& network) const {
+		assert(network.getParameterCount() == parameterCount && "Network must be the same shape as the pack");
+
+		std::vector<T> x(parameterCount);
+		for (uint p = 0; p < parameterCount; p++) {
+			x[p] = at(model, p);
+		}
+		network.setParameters(x.data());
+	}
+
+	// Sets examples of all models, each row is an example
+	void setExamples(const VMatrix<T>& in, const VMatrix<T>& out) {
+		for (uint m = 0; m < modelCount; m++) {
+			setExamples(m, in, out);
+		}
+	}
+
+	/* Sets examples of a single model, each row is an example
+	 * All models must have the same number of examples
+	 */
+	void setExamples(uint model, const VMatrix<T>& in, const VMatrix<T>& out) {
+		assert(in.getRowLength() == sizes.front() && out.getRowLength() == sizes.back() && "Examples must fit the pack");
+		assert((!exampleCount || exampleCount == in.getColumnLength()) && "All models need the same number of examples");
+
+		if (!exampleCount) {
+			exampleCount = in.getColumnLength();
+			input.assign((size_t)groupCount * exampleCount * sizes.front() * LANES, T(0));
+			output.assign((size_t)groupCount * exampleCount * sizes.back() * LANES, T(0));
+		}
+
+		const uint g = model / LANES, k = model % LANES;
+		const size_t inLength = (size_t)exampleCount * sizes.front(), outLength = (size_t)exampleCount * sizes.back();
+		for (size_t i = 0; i < inLength; i++) {
+			input[(g * inLength + i) * LANES + k] = in.qGet()[i];
+		}
+		for (size_t i = 0; i < outLength; i++) {
+			output[(g * outLength + i) * LANES + k] = out.qGet()[i];
+		}
+	}
+
+	/* Trains all models against their examples, LANES models at a time in lockstep
+	 * Each iteration steps the model in every lane that has not stopped
+	 * A model stops once its cost is no longer above CONVERGENCE_THRESHOLD, or after ITERATION_MAX iterations
+	 * and its lane is masked from later steps, until the next waiting model is moved into it
+	 * so lanes are kept busy however much the iterations of each model differ
+	 */
+	void train() {
+		const T CTHRESH = T(hParams.get(CONVERGENCE_THRESHOLD));
+		const uint ITERMAX = (uint)hParams.get(ITERATION_MAX);
+		const T LRATE = T(hParams.get(LEARNING_RATE));
+
+		assert(exampleCount && "Examples must be set before training");
+
+		// Working group, with parameters and examples of the model in each lane
+		std::vector<T> group((size_t)parameterCount * LANES, T(0));
+		std::vector<T> x((size_t)exampleCount * sizes.front() * LANES, T(0));
+		std::vector<T> y((size_t)exampleCount * sizes.back() * LANES, T(0));
+
+		Buffers buffers;
+		prepare(buffers, exampleCount);
+
+		// Model in each lane, and its step size, 0 once stopped
+		uint lane[LANES];
+		T step[LANES];
+		T cost[LANES];
+		std::fill(step, step + LANES, T(0));
+
+		stopwatch::tic();
+
+		uint next = 0, active = 0;
+		while (true) {
+			for (uint k = 0; k < LANES && next < modelCount; k++) {
+				if (step[k] == T(0)) {
+					moveLane(next, k, group.data(), x.data(), y.data(), false);
+					iterations[next] = 0;
+					lane[k] = next++;
+					step[k] = LRATE;
+					active++;
+				}
+			}
+			if (!active) {
+				break;
+			}
+
+			std::fill(cost, cost + LANES, T(0));
+			propogateForward(group.data(), x.data(), exampleCount, buffers);
+			propogateBackward(group.data(), x.data(), y.data(), exampleCount, buffers, cost);
+
+			const T* gradient = buffers.gradient.data();
+			for (uint p = 0; p < parameterCount; p++) {
+				for (uint k = 0; k < LANES; k++) {
+					group[p * LANES + k] -= step[k] * gradient[p * LANES + k];
+				}
+			}
+
+			// Stop models as Network does, after the iteration its cost is no longer above threshold
+			for (uint k = 0; k < LANES; k++) {
+				if (step[k] == T(0)) {
+					continue;
+				}
+				const uint m = lane[k];
+				costs[m] = cost[k];
+				iterations[m]++;
+				if (!(cost[k] > CTHRESH) || iterations[m] >= ITERMAX) {
+					converged[m] = cost[k] < CTHRESH;
+					moveLane(m, k, group.data(), x.data(), y.data(), true);
+					step[k] = T(0);
+					active--;
+				}
+			}
+		}
+
+		executionTime = stopwatch::tocGet();
+	}
+
+	/* Sets cost of each model against its examples into modelCosts, evaluating a group at a time
+	 */
+	void evaluate(T* modelCosts) const {
+		assert(exampleCount && "Examples must be set before evaluating");
+
+		Buffers buffers;
+		prepare(buffers, exampleCount);
+		const size_t inLength = (size_t)exampleCount * sizes.front() * LANES;
+		const size_t outLength = (size_t)exampleCount * sizes.back() * LANES;
+
+		for (uint g = 0; g < groupCount; g++) {
+			const T* x = input.data() + g * inLength;
+			const T* y = output.data() + g * outLength;
+			const T* a = buffers.activation.back().data();
+
+			propogateForward(parameters.data() + (size_t)g * parameterCount * LANES, x, exampleCount, buffers);
+			for (uint k = 0; k < LANES && isModel(g, k); k++) {
+				T cost = T(0);
+				for (size_t j = 0; j < (size_t)exampleCount * sizes.back(); j++) {
+					const T residual = a[j * LANES + k] - y[j * LANES + k];
+					cost += residual * residual;
+				}
+				modelCosts[g * LANES + k] = cost;
+			}
+		}
+	}
+
+	// Returns cost of a model at the end of last training
+	T getCost(uint model) const {
+		return costs[model];
+	}
+
+	// Returns number of iterations of a model in last training
+	uint getIterations(uint model) const {
+		return iterations[model];
+	}
+
+	// Returns true if a model converged in last training
+	bool isConverged(uint model) const {
+		return converged[model];
+	}
+
+	// Returns time taken by last training in seconds
+	double getExecutionTime() const {
+		return executionTime;
+	}
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,96 @@
+/* Benchmark of training many small networks at once
+ * Compares models per second of a ModelPack against training each Network in turn
+ * from the same initial weights, along with how closely results match */
+#ifndef __MODEL_PACK_BENCHMARK__
+#define __MODEL_PACK_BENCHMARK__
+
+#include <math.h>
+
+#include <iostream>
+
+#include "model_pack.hpp"
+
+namespace tests {
+	// Number of models trained, and iteration budget of each
+	const uint MPB_MODELS = 256;
+	const uint MPB_ITERATIONS = 20000;
+
+	/* Trains MPB_MODELS networks of given shape on a gate, one by one and in a pack
+	 * Prints models per second of each, models converged, and largest difference of parameters
+	 */
+	template <typename Act, uint LANES>
+	void mpb_compare(std::string name, std::vector<uint> sizes, double learningRate, bool fastMath,
+		const VMatrix<double>& input, const VMatrix<double>& output) {
+
+		const std::vector<uint> nodeCounts(sizes.begin() + 1, sizes.end());
+		std::vector<Network<double>> networks;
+		ModelPack<double, Act, LANES> pack(sizes, MPB_MODELS);
+		pack.getHParams().set(LEARNING_RATE, learningRate);
+		pack.getHParams().set(ITERATION_MAX, MPB_ITERATIONS);
+
+		rand_ex::reset();
+		for (uint m = 0; m < MPB_MODELS; m++) {
+			networks.push_back(Network<double>(sizes[0], Act::TYPE, nodeCounts, learningRate));
+			networks.back().getHParams().set(ITERATION_MAX, MPB_ITERATIONS);
+			networks.back().getHParams().set(FAST_MATH, fastMath ? 1.0 : 0.0);
+			networks.back().addExample(input, output);
+			pack.load(m, networks.back());
+		}
+		pack.setExamples(input, output);
+
+		double networkTime = 0.0;
+		uint networkConverged = 0;
+		for (auto& net : networks) {
+			net.train();
+			networkTime += net.getExecutionTime();
+			networkConverged += net.isConverged();
+		}
+
+		pack.train();
+
+		// Compare each model of the pack against its network
+		uint packConverged = 0, sameIterations = 0;
+		double difference = 0.0;
+		Network<double> packed(sizes[0], Act::TYPE, nodeCounts);
+		std::vector<double> x(packed.getParameterCount()), y(packed.getParameterCount());
+		for (uint m = 0; m < MPB_MODELS; m++) {
+			packConverged += pack.isConverged(m);
+			sameIterations += pack.getIterations(m) == networks[m].getIterations();
+			pack.store(m, packed);
+			packed.getParameters(x.data());
+			networks[m].getParameters(y.data());
+			for (uint i = 0; i < x.size(); i++) {
+				difference = (std::max)(difference, fabs(x[i] - y[i]));
+			}
+		}
+
+		std::cout << name << ", " << MPB_MODELS << " models:" << std::endl;
+		std::cout << "  Network one by one: " << MPB_MODELS / networkTime << " models/s, "
+			<< networkConverged << " converged" << std::endl;
+		std::cout << "  ModelPack of " << LANES << " lanes: " << MPB_MODELS / pack.getExecutionTime() << " models/s, "
+			<< packConverged << " converged" << std::endl;
+		std::cout << "  speedup " << networkTime / pack.getExecutionTime() << ", " << sameIterations
+			<< " with the same iterations, largest difference of parameters " << difference << std::endl;
+	}
+
+	/* Runs all benchmarks
+	 */
+	void runModelPackBenchmark() {
+		VMatrix<double> input(
+			{
+				{0.0, 0.0},
+				{0.0, 1.0},
+				{1.0, 0.0},
+				{1.0, 1.0}
+			}
+		);
+		VMatrix<double> andOutput({ {0.0}, {0.0}, {0.0}, {1.0} });
+		VMatrix<double> xorOutput({ {0.0}, {1.0}, {1.0}, {0.0} });
+
+		mpb_compare<activation::Sigmoid, 8>("AND Gate 2-1", { 2, 1 }, 1.0, false, input, andOutput);
+		mpb_compare<activation::Sigmoid, 8>("XOR Gate 2-2-1", { 2, 2, 1 }, 1.0, false, input, xorOutput);
+		mpb_compare<activation::FastSigmoid, 8>("XOR Gate 2-2-1 fast", { 2, 2, 1 }, 1.0, true, input, xorOutput);
+	}
+}
+
+#endif
\ No newline at end of file
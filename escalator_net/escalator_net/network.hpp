@@ -3,7 +3,24 @@
 #ifndef __NETWORK__
 #define __NETWORK__
 
+#include <string.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+
+#include "importance_sampler.hpp"
 #include "layer.hpp"
+#include "lbfgs.hpp"
+#include "loss.hpp"
+#include "memory_planner.hpp"
+#include "normaliser.hpp"
+#include "worker_group.hpp"
 #include "stopwatch.hpp"
 #include "hyper_parameters.h"
 
@@ -14,6 +31,35 @@ class Network;
 // Forward declaration of stream output
 template <typename T> static std::ostream& operator<<(std::ostream& os, const Network<T>& n);
 
+ // Reasons training stops
+enum class StopReasons {
+	none,
+	// Cost fell below CONVERGENCE_THRESHOLD
+	converged,
+	iterationMax,
+	cancelled,
+	// Time given to partial training ran out
+	timeLimit,
+	// Validation cost did not improve for PATIENCE evaluations
+	earlyStop,
+	// Training cost did not improve for PLATEAU evaluations, or L-BFGS can make no progress
+	plateau,
+	// Cost became NaN or infinite
+	diverged,
+};
+
+// Map of StopReasons to string name
+const std::map<StopReasons, std::string> STOP_REASONS_TO_NAME = {
+	{StopReasons::none, "none"},
+	{StopReasons::converged, "converged"},
+	{StopReasons::iterationMax, "iteration max"},
+	{StopReasons::cancelled, "cancelled"},
+	{StopReasons::timeLimit, "time limit"},
+	{StopReasons::earlyStop, "early stop"},
+	{StopReasons::plateau, "plateau"},
+	{StopReasons::diverged, "diverged"}
+};
+
  /* Contains a full network
   */
 template <typename T>
@@ -31,6 +77,25 @@ private:
 	// Internal Output
 	VMatrix<T> internalOutput = VMatrix <T>(1, 1);
 
+	// Number of times each internal example was added, empty unless examples are deduplicated
+	std::vector<T> internalWeights;
+
+	// Rows of internal examples by hash, used to find repeats while deduplicating
+	std::unordered_multimap<uint64, uint> exampleIndex;
+
+	// Set when rows have moved since exampleIndex was built
+	bool indexStale = true;
+
+	// Set once examples are shuffled for a held out split, cleared when examples are added
+	bool splitDrawn = false;
+
+	// Statistics of input of internal examples, gathered as they are added
+	Normaliser<T> inputStatistics;
+
+	// Input of the first layer is (x - inputShift) * inputScale, both empty if input is used as given
+	std::vector<T> inputShift;
+	std::vector<T> inputScale;
+
 	// Hyper parameters for optimisation
 	HyperParameters hParams;
 
@@ -40,19 +105,834 @@ private:
 	// number of iterations for last optimisation
 	uint count = 0;
 
+	// number of passes over the training set for last optimisation
+	uint epochs = 0;
+
 	// cost for last iteraion
 	T cost = T(0);
 
+	// cost over held out examples at the end of last optimisation
+	T validationCost = T(0);
+
+	// number of times the network grew over last optimisation
+	uint growths = 0;
+
+	// number of times L-BFGS started again from new weights over last optimisation
+	uint restarts = 0;
+
+	// Scheme weights were last randomised with, used again by restarts
+	InitialisationTypes initialisation = InitialisationTypes::uniform;
+
+	// Why last optimisation stopped
+	StopReasons stopReason = StopReasons::none;
+
 	// List of hidden layers
 	std::vector<Layer<T>> layers;
 
-	// Last output from forward propogation
-	VMatrix<T> lastPrediction = VMatrix <T>(1, 1);
+	// Updates parameters of layers, state is kept by each layer
+	Optimizer<T> optimizer;
+
+	// Set once state of optimizer has been set up in all layers
+	bool optimizerReady = false;
+
+	// When set, training stops at the end of the current epoch
+	const std::atomic<bool>* cancelFlag = nullptr;
+
+	bool isCancelled() const {
+		return cancelFlag && cancelFlag->load(std::memory_order_relaxed);
+	}
+
+	/// Buffers for training
+	// Ids of each layers activation, dadz and dcda in a memory plan
+	struct BufferIds {
+		uint activation;
+		uint dadz;
+		uint dcda;
+		// Only planned for layers over images, NO_SCRATCH otherwise
+		uint scratch;
+	};
+
+	static const uint NO_SCRATCH = ~0u;
+
+	/* Buffers for training used by a single thread
+	 * Buffers of all layers share a pool based on when each is used
+	 * Aligned to cache lines, so workers do not share lines
+	 */
+	struct alignas(CACHE_LINE) Workspace {
+		MemoryPlan<T> memoryPlan;
+
+		// Batch size memory is currently planned for, 0 if unplanned
+		uint plannedBatch = 0;
+
+		std::vector<BufferIds> bufferIds;
+
+		// Id of normalised input, only planned if input is normalised
+		uint normalisedInput = 0;
+
+		// Input of last forward propogation, owned by caller
+		VMatrixView<T> lastInput = VMatrixView<T>(nullptr, 0, 0);
+
+		// Gradient of all layers from last backward propogation, as a flat vector
+		std::vector<T, CacheAllocator<T>> gradient;
+
+		// Rows of gradient of a first layer embedding that may be non zero, all rows may be unless rowsKnown
+		std::vector<uint> embeddingRows;
+		bool rowsKnown = false;
+
+		// Cost from last backward propogation
+		T cost = T(0);
+
+		// Returns buffers of the l-th layer
+		LayerBuffers<T> getBuffers(uint l) {
+			LayerBuffers<T> buffers;
+			buffers.activation = memoryPlan.get(bufferIds[l].activation);
+			buffers.dadz = memoryPlan.get(bufferIds[l].dadz);
+			buffers.dcda = memoryPlan.get(bufferIds[l].dcda);
+			if (bufferIds[l].scratch != NO_SCRATCH) {
+				buffers.scratch = memoryPlan.get(bufferIds[l].scratch);
+			}
+			return buffers;
+		}
+	};
+
+	// Buffers for training on the calling thread
+	Workspace workspace;
+
+	// Buffers for each worker of data parallel training
+	std::vector<Workspace> workers;
+
+	// Buffers for evaluating held out examples, kept apart so training buffers are not replanned
+	Workspace validation;
+
+	/* Plans buffers of w for training on given batch size
+	 * An iteration of L layers runs over the steps:
+	 * forward propogation of layer l on step l, cost on step L
+	 * and backward propogation of layer l on step 2L - l
+	 * Only replans if batch is larger than currently planned for
+	 */
+	void planMemory(Workspace& w, uint batch) const {
+		if (batch <= w.plannedBatch) {
+			return;
+		}
+
+		w.memoryPlan.clear();
+		w.bufferIds.clear();
+
+		const uint L = (uint)layers.size();
+		for (uint l = 0; l < L; l++) {
+			const size_t length = (size_t)layers[l].getNodeCount() * batch;
+			BufferIds ids;
+			// Read by the next layer forward and backward, or by cost for the last layer
+			ids.activation = w.memoryPlan.request("activation", l, length, l, 2 * L - l - 1);
+			// Read on backward propogation of this layer
+			ids.dadz = w.memoryPlan.request("dadz", l, length, l, 2 * L - l);
+			// Set by the layer after, and read on backward propogation of this layer
+			ids.dcda = w.memoryPlan.request("dcda", l, length, 2 * L - l - 1, 2 * L - l);
+			// Set on forward propogation of this layer, and read on backward propogation
+			const size_t scratch = layers[l].getScratchSize(batch);
+			ids.scratch = scratch ? w.memoryPlan.request("scratch", l, scratch, l, 2 * L - l) : NO_SCRATCH;
+			w.bufferIds.push_back(ids);
+		}
+
+		// Read by the first layer forward and backward
+		if (isNormalised()) {
+			w.normalisedInput = w.memoryPlan.request("input", 0, (size_t)layers[0].getInputSize() * batch, 0, 2 * L);
+		}
+
+		w.memoryPlan.plan();
+		w.plannedBatch = batch;
+		w.gradient.resize(getParameterCount());
+		w.rowsKnown = false;
+	}
+
+	// Drops plans of all workspaces, so buffers are replanned for new sizes of layers
+	void clearMemoryPlans() {
+		workspace.plannedBatch = 0;
+		validation.plannedBatch = 0;
+		for (auto& w : workers) {
+			w.plannedBatch = 0;
+		}
+	}
+
+	/* Forward propogates through all layers with buffers of w
+	 * Input is normalised into buffers of w as it is loaded, if a transform is set
+	 * Only reads parameters, so may be called from many threads at once
+	 * Returns view of predicted outputs
+	 */
+	VMatrixView<T> forwardPropogate(Workspace& w, const VMatrixView<T>& input) const {
+		assert(input.getRowLength() == layers.front().getInputSize() && "Input must be the size of the input layer");
+
+		const uint batch = input.getColumnLength();
+		planMemory(w, batch);
+		w.lastInput = input;
+
+		// Backward propogation of the first layer reads the normalised input
+		if (isNormalised()) {
+			T* normalised = w.memoryPlan.get(w.normalisedInput);
+			kernels::normalise(input.qGet(), batch, input.getRowLength(), inputShift.data(), inputScale.data(), normalised);
+			w.lastInput = VMatrixView<T>(normalised, input.getRowLength(), batch);
+		}
+
+		// Input for next layer is the activation of the last
+		const T* next = w.lastInput.qGet();
+		for (uint l = 0; l < layers.size(); l++) {
+			LayerBuffers<T> buffers = w.getBuffers(l);
+			layers[l].propogateForward(next, batch, buffers);
+			next = buffers.activation;
+		}
+
+		return VMatrixView<T>(next, layers.back().getNodeCount(), batch);
+	}
+
+	/* Backward propogates through all layers with buffers of w
+	 * Sets w.gradient to the sum over input times scale
+	 * If given, each input is weighted by weights, and rowCosts set to the unweighted cost of each input
+	 * With embeddingRows, a first layer embedding only clears and sets rows of w.gradient for its ids
+	 * and lists them in w.embeddingRows
+	 * Only reads parameters, so may be called from many threads at once
+	 * returns cost if evaluateCost, otherwise 0
+	 */
+	T backwardPropogate(Workspace& w, const VMatrixView<T>& YObs, bool evaluateCost, T scale,
+		const T* weights = nullptr, T* rowCosts = nullptr, bool embeddingRows = false) const {
+		const uint batch = w.lastInput.getColumnLength();
+		const uint L = (uint)layers.size();
+		T cost = T(0);
+
+		// dcda of the output layer from cost
+		LayerBuffers<T> buffers = w.getBuffers(L - 1);
+		cost = loss::weightedCostAndDerivative(
+			getLoss(), buffers.activation, YObs.qGet(), batch, layers.back().getNodeCount(), buffers.dcda, evaluateCost,
+			weights, rowCosts
+		);
+
+		// Iterate through backwards
+		// Gradient of layer l is at offset in w.gradient
+		uint offset = getParameterCount();
+		for (uint l = L; l--;) {
+			buffers = w.getBuffers(l);
+			const T* input = l ? w.getBuffers(l - 1).activation : w.lastInput.qGet();
+			offset -= layers[l].getParameterCount();
+
+			std::vector<uint>* rows = nullptr;
+			if (!l && embeddingRows) {
+				// Rows are cleared once, after which only rows of the last batch need clearing
+				if (!w.rowsKnown) {
+					alg::fill(w.gradient.data(), layers[0].getParameterCount(), T(0));
+					w.embeddingRows.clear();
+					w.rowsKnown = true;
+				}
+				rows = &w.embeddingRows;
+			}
+			else if (!l) {
+				w.rowsKnown = false;
+			}
+
+			layers[l].propogateBackwards(input, batch, buffers, w.gradient.data() + offset, scale, rows);
+
+			// compute dcda of previous layer
+			if (l) {
+				layers[l].propogateInput(buffers, batch, w.getBuffers(l - 1).dcda);
+			}
+		}
+
+		return cost;
+	}
+
+	/* Forward and backward propogates a batch split across workers
+	 * Each worker computes gradient over its share of the batch
+	 * which are summed with a pairwise tree in a fixed order
+	 * so results are reproducible for a given number of workers
+	 * If given, each example is weighted by weights
+	 * Sets gradient of all layers, returns cost if evaluateCost
+	 */
+	T propogateParallel(WorkerGroup& group, const VMatrixView<T>& input, const VMatrixView<T>& output, bool evaluateCost,
+		const T* weights = nullptr) {
+		const uint W = group.size();
+		const uint batch = input.getColumnLength();
+		const uint length = getParameterCount();
+		const T scale = T(1) / sumWeights(weights, batch);
+
+		group.run(
+			[&](uint i) {
+				Workspace& w = workers[i];
+				const uint start = (uint)((uint64)batch * i / W);
+				const uint end = (uint)((uint64)batch * (i + 1) / W);
+
+				if (start == end) {
+					planMemory(w, 1);
+					alg::fill(w.gradient.data(), length, T(0));
+					w.cost = T(0);
+					return;
+				}
+
+				forwardPropogate(w, input.getRows(start, end - start));
+				w.cost = backwardPropogate(
+					w, output.getRows(start, end - start), evaluateCost, scale, weights ? weights + start : nullptr
+				);
+			}
+		);
+
+		// Each worker reduces a slice of gradient, into gradient of worker 0
+		group.run(
+			[&](uint i) {
+				const uint start = (uint)((uint64)length * i / W);
+				const uint end = (uint)((uint64)length * (i + 1) / W);
+
+				for (uint stride = 1; stride < W; stride *= 2) {
+					for (uint j = 0; j + stride < W; j += 2 * stride) {
+						kernels::axpy(
+							workers[j].gradient.data() + start, workers[j + stride].gradient.data() + start, T(1), end - start
+						);
+					}
+				}
+			}
+		);
+
+		// Cost is reduced in the same order
+		for (uint stride = 1; stride < W; stride *= 2) {
+			for (uint j = 0; j + stride < W; j += 2 * stride) {
+				workers[j].cost += workers[j + stride].cost;
+			}
+		}
+
+		setGradient(workers[0].gradient.data());
+		return workers[0].cost;
+	}
+
+	/* Runs an epoch of Hogwild training, over at most iterationMax batches
+	 * Workers take the next batch until all are taken, and each applies
+	 * its SGD update to the shared parameters straight away without locks
+	 * Parameters may be read while another worker writes them, and updates may be lost
+	 * which is accepted for throughput, as aligned loads and stores of T are not torn on x86 and x64
+	 * If given, each example is weighted by weights
+	 * Adds cost of each batch to epochCost, returns number of batches run
+	 */
+	uint propogateHogwild(WorkerGroup& group, const VMatrixView<T>& input, const VMatrixView<T>& output, const T* weights,
+		uint batchSize, bool evaluateCost, uint iterationMax, double LRATE, T& epochCost) {
+
+		const uint examples = input.getColumnLength();
+		const uint batches = (std::min)((examples + batchSize - 1) / batchSize, iterationMax);
+		std::atomic<uint> next(0);
+
+		group.run(
+			[&](uint i) {
+				Workspace& w = workers[i];
+				T cost = T(0);
+
+				for (uint b; (b = next.fetch_add(1, std::memory_order_relaxed)) < batches;) {
+					const uint start = b * batchSize;
+					const uint size = (std::min)(batchSize, examples - start);
+
+					forwardPropogate(w, input.getRows(start, size));
+					const T* batchWeights = weights ? weights + start : nullptr;
+					cost += backwardPropogate(
+						w, output.getRows(start, size), evaluateCost, T(1) / sumWeights(batchWeights, size), batchWeights
+					);
+
+					T* g = w.gradient.data();
+					for (auto& layer : layers) {
+						kernels::sgdStep(layer.getParameters(), g, layer.getParameterCount(), T(LRATE));
+						g += layer.getParameterCount();
+					}
+				}
+
+				w.cost = cost;
+			}
+		);
+
+		for (auto& w : workers) {
+			epochCost += w.cost;
+		}
+		return batches;
+	}
+
+	// Sets gradient of all layers from a single flat vector g
+	void setGradient(const T* g, const std::vector<uint>* embeddingRows = nullptr) {
+		for (auto& i : layers) {
+			if (embeddingRows && &i == &layers[0]) {
+				i.setGradientRows(g, *embeddingRows);
+			}
+			else {
+				i.setGradient(g);
+			}
+			g += i.getParameterCount();
+		}
+	}
+
+	// Returns sum of count weights, or count if weights is not given
+	static T sumWeights(const T* weights, uint count) {
+		if (!weights) {
+			return T(count);
+		}
+		T total = T(0);
+		for (uint i = 0; i < count; i++) {
+			total += weights[i];
+		}
+		return total;
+	}
+
+	/* Returns cost over input and output, with buffers of w
+	 * If given, each example is weighted by weights
+	 * Does not change gradient
+	 */
+	T validate(Workspace& w, const VMatrixView<T>& input, const VMatrixView<T>& output, const T* weights = nullptr) const {
+		forwardPropogate(w, input);
+		LayerBuffers<T> buffers = w.getBuffers((uint)layers.size() - 1);
+		return loss::weightedCostAndDerivative(
+			getLoss(), buffers.activation, output.qGet(), output.getColumnLength(), output.getRowLength(), buffers.dcda, true,
+			weights, (T*)nullptr
+		);
+	}
+
+	/* Trains this network against input and output
+	 * Each epoch is a pass over all examples in batches of BATCH_SIZE
+	 * Cost is the sum of the cost of each batch over an epoch
+	 * Each batch is split over THREAD_COUNT workers
+	 * or with HOGWILD, each worker takes its own batches and updates without locks
+	 * Examples are only shuffled if owned by this network
+	 * Owned examples that were deduplicated count once for each time they were added
+	 *
+	 * The last VALIDATION_SPLIT of examples are held out, and their cost evaluated with training cost
+	 * Owned examples are split once after they are added, and only training examples are shuffled after
+	 * Training stops early after PATIENCE evaluations without a lower validation cost
+	 * and parameters are restored to those with the lowest validation cost
+	 *
+	 * On a plateau, the network grows by GROW_WIDTH and GROW_DEPTH up to GROW_LIMIT times before stopping
+	 * Growth keeps the function of the network, so training carries on from the same cost
+	 * Parameters kept for the lowest validation cost are dropped on growth, as they no longer fit
+	 */
+	void trainExamples(const VMatrixView<T>& input, const VMatrixView<T>& output, bool ownsExamples, bool print) {
+
+		// Cache some hyper parameters
+		const double CTHRESH = hParams.get(CONVERGENCE_THRESHOLD);
+		const uint ITERMAX = (uint)hParams.get(ITERATION_MAX);
+		const uint CINTERVAL = (std::max)((uint)hParams.get(COST_INTERVAL), 1u);
+		const uint BATCHSIZE = (uint)hParams.get(BATCH_SIZE);
+		const bool SHUFFLEEPOCH = hParams.get(SHUFFLE) != 0.0;
+		const uint THREADCOUNT = (std::max)((uint)hParams.get(THREAD_COUNT), 1u);
+		const bool HOGWILDMODE = hParams.get(HOGWILD) != 0.0 && THREADCOUNT > 1;
+		const double LRATE = hParams.get(LEARNING_RATE);
+		const double VSPLIT = hParams.get(VALIDATION_SPLIT);
+		const uint PATIENCECOUNT = (uint)hParams.get(PATIENCE);
+		const uint PLATEAUCOUNT = (uint)hParams.get(PLATEAU);
+		const double PTOLERANCE = hParams.get(PLATEAU_TOLERANCE);
+		const uint GROWLIMIT = (uint)hParams.get(GROW_LIMIT);
+		const uint GROWWIDTH = (uint)hParams.get(GROW_WIDTH);
+		const uint GROWDEPTH = (uint)hParams.get(GROW_DEPTH);
+
+		setMathMode();
+		setLoss();
+		if (getNormalisationType() != NormalisationTypes::none) {
+			normaliseFrom(input, ownsExamples);
+		}
+		resetOptimizer();
+
+		// Held out examples are a random sample if examples can be shuffled
+		// drawn once, so later training keeps the same held out examples
+		const uint total = input.getColumnLength();
+		const uint held = (std::min)((uint)(VSPLIT * total), total - 1);
+		if (held && SHUFFLEEPOCH && ownsExamples && !splitDrawn) {
+			shuffleExamples();
+			splitDrawn = true;
+		}
+		const uint examples = total - held;
+		const VMatrixView<T> trainInput = input.getRows(0, examples);
+		const VMatrixView<T> trainOutput = output.getRows(0, examples);
+		const VMatrixView<T> validInput = input.getRows(examples, held);
+		const VMatrixView<T> validOutput = output.getRows(examples, held);
+
+		// Weight of each example, after shuffling
+		const T* weights = ownsExamples && !internalWeights.empty() ? internalWeights.data() : nullptr;
+		const T* validWeights = weights ? weights + examples : nullptr;
+
+		validationCost = T(0);
+		growths = 0;
+		restarts = 0;
+
+		// Full batch if batch size is unset or larger than training set
+		const uint batchSize = BATCHSIZE && BATCHSIZE < examples ? BATCHSIZE : examples;
+
+		// Full training modes, which only evaluate held out examples at the end
+		const bool importance = hParams.get(SAMPLING) != 0.0 && batchSize < examples;
+		if (optimizer.getType() == OptimizerTypes::LBFGS || importance) {
+			if (importance) {
+				trainImportance(trainInput, trainOutput, weights, batchSize, print);
+			}
+			else {
+				trainLBFGS(trainInput, trainOutput, weights, print);
+			}
+			if (held) {
+				validationCost = validate(validation, validInput, validOutput, validWeights);
+			}
+			return;
+		}
+
+		// Workers for data parallel training, only the calling thread if THREADCOUNT is 1
+		WorkerGroup group(THREADCOUNT);
+		workers.resize(THREADCOUNT);
+
+		// Prepare updated variables
+		cost = T(CTHRESH + T(1));
+		count = 0;
+		epochs = 0;
+		stopReason = StopReasons::none;
+
+		// Parameters with lowest validation cost, and evaluations since cost last improved
+		std::vector<T> best;
+		T bestValidation = std::numeric_limits<T>::infinity();
+		T bestCost = std::numeric_limits<T>::infinity();
+		uint sinceValidation = 0, sincePlateau = 0;
+
+		stopwatch::tic();
+
+		while (cost > CTHRESH && count < ITERMAX && !isCancelled()) {
+			if (SHUFFLEEPOCH && ownsExamples && batchSize < examples) {
+				shuffleExamples(examples);
+			}
+
+			// Cost is only updated every CINTERVAL epochs
+			const bool evaluateCost = !(epochs % CINTERVAL);
+			T epochCost = T(0);
+
+			uint start = 0;
+			if (HOGWILDMODE) {
+				const uint batches = propogateHogwild(group, trainInput, trainOutput, weights, batchSize, evaluateCost, ITERMAX - count, LRATE, epochCost);
+				start = (std::min)(batches * batchSize, examples);
+				count += batches;
+			}
+
+			for (; start < examples && count < ITERMAX; start += batchSize) {
+				const uint size = (std::min)(batchSize, examples - start);
+				const T* batchWeights = weights ? weights + start : nullptr;
+
+				if (THREADCOUNT > 1) {
+					epochCost += propogateParallel(
+						group, trainInput.getRows(start, size), trainOutput.getRows(start, size), evaluateCost, batchWeights
+					);
+				}
+				else {
+					// capture activation from forward propogation
+					forwardPropogate(trainInput.getRows(start, size));
+
+					// Apply an interation of backprop
+					epochCost += backwardPropogate(trainOutput.getRows(start, size), evaluateCost, batchWeights);
+				}
+				applyGradients();
+
+				count++;
+			}
+
+			// Partial epochs do not estimate cost
+			if (evaluateCost && start >= examples) {
+				cost = epochCost;
+
+				if (!std::isfinite((double)cost)) {
+					stopReason = StopReasons::diverged;
+					break;
+				}
+
+				if (PLATEAUCOUNT) {
+					sincePlateau = cost < bestCost * T(1 - PTOLERANCE) ? 0 : sincePlateau + 1;
+					bestCost = (std::min)(bestCost, cost);
+					if (sincePlateau >= PLATEAUCOUNT && growths < GROWLIMIT) {
+						grow(GROWWIDTH, GROWDEPTH);
+						growths++;
+						sincePlateau = 0;
+						best.clear();
+						bestValidation = std::numeric_limits<T>::infinity();
+					}
+					else if (sincePlateau >= PLATEAUCOUNT) {
+						stopReason = StopReasons::plateau;
+						break;
+					}
+				}
+
+				if (held) {
+					validationCost = validate(validation, validInput, validOutput, validWeights);
+					if (validationCost < bestValidation) {
+						bestValidation = validationCost;
+						best.resize(getParameterCount());
+						getParameters(best.data());
+						sinceValidation = 0;
+					}
+					else if (PATIENCECOUNT && ++sinceValidation >= PATIENCECOUNT) {
+						stopReason = StopReasons::earlyStop;
+						break;
+					}
+				}
+			}
+
+			if (print && !(epochs % 10000)) {
+				std::cout << "Cost: " << cost << " Left: " << ITERMAX - count << std::endl;
+			}
+
+			epochs++;
+		}
+
+		// Keep parameters with the lowest validation cost, and update cost to match
+		if (!best.empty() && !(validationCost <= bestValidation)) {
+			setParameters(best.data());
+			validationCost = bestValidation;
+			cost = validate(validation, trainInput, trainOutput, weights);
+		}
+
+		executionTime = stopwatch::tocGet();
+
+		// Set convergence flag
+		converged = cost < CTHRESH;
+		setStopReason(ITERMAX);
+	}
+
+	/* Sets cost of each example in input against output into costs, with batches of size batch
+	 * returns sum of costs, each multiplied by its weight if weights is given
+	 */
+	T exampleCosts(const VMatrixView<T>& input, const VMatrixView<T>& output, const T* weights, uint batch, T* costs) {
+		const uint examples = input.getColumnLength();
+		const uint n = layers.back().getNodeCount();
+		T total = T(0);
+		for (uint start = 0; start < examples; start += batch) {
+			const uint size = (std::min)(batch, examples - start);
+			forwardPropogate(workspace, input.getRows(start, size));
+			LayerBuffers<T> buffers = workspace.getBuffers((uint)layers.size() - 1);
+			total += loss::weightedCostAndDerivative(
+				getLoss(), buffers.activation, output.getRows(start, size).qGet(), size, n, buffers.dcda, true,
+				weights ? weights + start : nullptr, costs + start
+			);
+		}
+		return total;
+	}
+
+	/* Trains with batches drawn in proportion to an estimate of the loss of each example
+	 * Each example is weighted by the inverse of its probability, so gradients are unbiased
+	 * Estimates are updated from each batch, and refreshed with a full pass every REFRESH_INTERVAL epochs
+	 * An epoch is as many batches as cover the examples once
+	 * Convergence is only accepted from the cost of a full pass
+	 * If given, each example is drawn in proportion to its weight as well
+	 */
+	void trainImportance(const VMatrixView<T>& input, const VMatrixView<T>& output, const T* exampleWeights,
+		uint batchSize, bool print) {
+		const double CTHRESH = hParams.get(CONVERGENCE_THRESHOLD);
+		const uint ITERMAX = (uint)hParams.get(ITERATION_MAX);
+		const uint REFRESH = (std::max)((uint)hParams.get(REFRESH_INTERVAL), 1u);
+
+		const uint examples = input.getColumnLength();
+		const uint batchesPerEpoch = (examples + batchSize - 1) / batchSize;
+
+		ImportanceSampler<T> sampler;
+		sampler.resize(examples, exampleWeights);
+
+		// Batch gathered from sampled examples
+		VMatrix<T> batchInput(input.getRowLength(), batchSize, T(0));
+		VMatrix<T> batchOutput(output.getRowLength(), batchSize, T(0));
+		std::vector<uint> indices(batchSize);
+		std::vector<T> weights(batchSize), rowCosts(batchSize);
+
+		count = 0;
+		epochs = 0;
+		stopReason = StopReasons::none;
+
+		stopwatch::tic();
+
+		cost = exampleCosts(input, output, exampleWeights, batchSize, sampler.getLosses());
+
+		while (cost > CTHRESH && count < ITERMAX && !isCancelled()) {
+			sampler.build();
+
+			for (uint b = 0; b < batchesPerEpoch && count < ITERMAX; b++) {
+				sampler.sample(indices.data(), weights.data(), batchSize);
+				for (uint i = 0; i < batchSize; i++) {
+					alg::copy(input.getRows(indices[i], 1).qGet(), batchInput.qGet() + i * input.getRowLength(), input.getRowLength());
+					alg::copy(output.getRows(indices[i], 1).qGet(), batchOutput.qGet() + i * output.getRowLength(), output.getRowLength());
+				}
+
+				forwardPropogate(workspace, batchInput);
+				backwardPropogate(workspace, batchOutput, true, T(1) / T(batchSize), weights.data(), rowCosts.data());
+				setGradient(workspace.gradient.data());
+				applyGradients();
+
+				sampler.update(indices.data(), rowCosts.data(), batchSize);
+				count++;
+			}
+			epochs++;
+
+			// Estimate from sampled examples, confirmed with a full pass before converging
+			cost = sampler.getTotal();
+			if (!(cost > CTHRESH) || !(epochs % REFRESH)) {
+				cost = exampleCosts(input, output, exampleWeights, batchSize, sampler.getLosses());
+			}
+
+			if (!std::isfinite((double)cost)) {
+				stopReason = StopReasons::diverged;
+				break;
+			}
+
+			if (print && !(epochs % 10000)) {
+				std::cout << "Cost: " << cost << " Left: " << ITERMAX - count << std::endl;
+			}
+		}
+
+		executionTime = stopwatch::tocGet();
+		converged = cost < CTHRESH;
+		setStopReason(ITERMAX);
+	}
+
+	// Returns hash of the bytes of an example, FNV-1a over input then output
+	static uint64 hashExample(const T* input, uint inputLength, const T* output, uint outputLength) {
+		uint64 hash = 14695981039346656037ull;
+		const uint8* bytes = (const uint8*)input;
+		for (size_t i = 0; i < sizeof(T) * inputLength; i++) {
+			hash = (hash ^ bytes[i]) * 1099511628211ull;
+		}
+		bytes = (const uint8*)output;
+		for (size_t i = 0; i < sizeof(T) * outputLength; i++) {
+			hash = (hash ^ bytes[i]) * 1099511628211ull;
+		}
+		return hash;
+	}
+
+	// Returns row of an indexed internal example with the same bytes as input and output, or -1 if none
+	int findExample(uint64 hash, const T* input, const T* output) const {
+		const uint inputLength = internalInput.getRowLength();
+		const uint outputLength = internalOutput.getRowLength();
+
+		auto range = exampleIndex.equal_range(hash);
+		for (auto i = range.first; i != range.second; i++) {
+			const size_t row = i->second;
+			if (!memcmp(internalInput.qGet() + row * inputLength, input, sizeof(T) * inputLength)
+				&& !memcmp(internalOutput.qGet() + row * outputLength, output, sizeof(T) * outputLength)) {
+				return (int)i->second;
+			}
+		}
+		return -1;
+	}
+
+	/* Merges internal examples from row first onwards into an earlier example with the same bytes
+	 * Rows before first must already be unique and indexed, all rows are indexed if first is 0
+	 * Weight of a merged example is added to the one kept, and order of those kept is unchanged
+	 */
+	void mergeExamples(uint first) {
+		const uint rows = internalInput.getColumnLength();
+		const uint inputLength = internalInput.getRowLength();
+		const uint outputLength = internalOutput.getRowLength();
+
+		if (!first) {
+			exampleIndex.clear();
+		}
+		internalWeights.resize(rows, T(1));
+
+		uint unique = first;
+		for (uint r = first; r < rows; r++) {
+			const T* input = internalInput.qGet() + (size_t)r * inputLength;
+			const T* output = internalOutput.qGet() + (size_t)r * outputLength;
+			const uint64 hash = hashExample(input, inputLength, output, outputLength);
+
+			const int found = findExample(hash, input, output);
+			if (found >= 0) {
+				internalWeights[found] += internalWeights[r];
+				continue;
+			}
+
+			if (unique != r) {
+				alg::copy(input, internalInput.qGet() + (size_t)unique * inputLength, inputLength);
+				alg::copy(output, internalOutput.qGet() + (size_t)unique * outputLength, outputLength);
+				internalWeights[unique] = internalWeights[r];
+			}
+			exampleIndex.emplace(hash, unique++);
+		}
+
+		internalInput.truncate(unique);
+		internalOutput.truncate(unique);
+		internalWeights.resize(unique);
+		indexStale = false;
+	}
+
+	/* Prunes the fraction sparsity of candidates with the smallest magnitude
+	 * Each candidate is a struct of magnitude, layer and index of a weight
+	 */
+	template <typename C>
+	void pruneSmallest(std::vector<C>& candidates, double sparsity) {
+		const size_t count = (std::min)((size_t)(sparsity * candidates.size()), candidates.size());
+		if (!count) {
+			return;
+		}
+
+		std::nth_element(candidates.begin(), candidates.begin() + (count - 1), candidates.end(),
+			[](const C& a, const C& b) {
+				return a.magnitude < b.magnitude;
+			}
+		);
+
+		std::vector<std::vector<uint>> indices(layers.size());
+		for (size_t i = 0; i < count; i++) {
+			indices[candidates[i].layer].push_back(candidates[i].index);
+		}
+		for (uint l = 0; l < layers.size(); l++) {
+			if (!indices[l].empty()) {
+				layers[l].prune(indices[l]);
+			}
+		}
+	}
+
+	// Rebuilds compressed weights of pruned layers, after parameters change
+	void compressLayers() {
+		for (auto& i : layers) {
+			i.compress();
+		}
+	}
+
+	/* Sets transform of input from statistics of internal examples if owned, otherwise from a pass over input
+	 * Parameters of a network that has been trained are changed to keep its function
+	 */
+	void normaliseFrom(const VMatrixView<T>& input, bool ownsExamples) {
+		// Category ids are used as given
+		if (layers[0].getShape().kind == LayerKinds::embedding) {
+			return;
+		}
+
+		Normaliser<T> pass;
+		if (!ownsExamples) {
+			pass.add(input.qGet(), input.getColumnLength(), input.getRowLength());
+		}
+
+		std::vector<T> shift, scale;
+		(ownsExamples ? inputStatistics : pass).getTransform(getNormalisationType(), shift, scale);
+		setNormalisation(shift, scale, optimizerReady);
+	}
+
+	// Sets reason training stopped, if not already set by an early stop
+	void setStopReason(uint iterationMax) {
+		if (converged) {
+			stopReason = StopReasons::converged;
+		}
+		else if (stopReason != StopReasons::none) {
+			return;
+		}
+		else if (isCancelled()) {
+			stopReason = StopReasons::cancelled;
+		}
+		else if (count >= iterationMax) {
+			stopReason = StopReasons::iterationMax;
+		}
+	}
 
 	// Declare outstream print as a friend ))
-	template <typename T> friend std::ostream& operator<<(std::ostream& os, const Network<T>& n);
+	template <typename U> friend std::ostream& operator<<(std::ostream& os, const Network<U>& n);
 
 public:
+	/* Scratch space for inference
+	 * Layers alternate between the two buffers
+	 * Each thread making predictions needs its own
+	 */
+	struct InferenceScratch {
+		std::vector<T> buffers[2];
+
+		// Normalised input
+		std::vector<T> input;
+
+		// Columns of input of a convolution
+		std::vector<T> scratch;
+	};
+
 	// Generate network with given number of hidden layers
 	// All using same activation function
 	Network(uint inputWidth, FunctionTypes type, std::vector<uint> nodeCounts) {
@@ -64,6 +944,28 @@ public:
 		}
 	}
 
+	// Generate network with given number of hidden layers
+	// All using same activation function, with given learning rate
+	Network(uint inputWidth, FunctionTypes type, std::vector<uint> nodeCounts, double learningRate)
+		: Network<T>(inputWidth, type, nodeCounts) {
+		hParams.set(LEARNING_RATE, learningRate);
+	}
+
+	/* Generate network with layers of given shapes, which may be over images
+	 * All using same activation function, with given learning rate
+	 * The input size of each layer is the node count of the layer before
+	 * Only the first layer may be an embedding, which takes category ids as input
+	 */
+	Network(uint inputWidth, FunctionTypes type, std::vector<LayerShape> shapes, double learningRate) {
+		uint nextWidth = inputWidth;
+		for (auto& i : shapes) {
+			assert((layers.empty() || i.kind != LayerKinds::embedding) && "Only the first layer may be an embedding");
+			layers.push_back(Layer<T>(nextWidth, i, type));
+			nextWidth = layers.back().getNodeCount();
+		}
+		hParams.set(LEARNING_RATE, learningRate);
+	}
+
 	// Generate network with given number of all layers
 	// Using more default parameters
 	Network(std::vector<uint> nodeCounts, std::string name)
@@ -75,18 +977,193 @@ public:
 		return hParams;
 	}
 
-	// Forward propogates through all layers
-	// Returns vector of predicted outputs from last iteration
-	VMatrix<T> forwardPropogate(const VMatrix<T>& input, double LRATE) {
+	// Sets flag that stops training once set, from any thread
+	void setCancelFlag(const std::atomic<bool>* flag) {
+		cancelFlag = flag;
+	}
+
+	// Returns true if last training converged
+	bool isConverged() const {
+		return converged;
+	}
+
+	// Returns number of iterations of last training
+	uint getIterations() const {
+		return count;
+	}
 
-		// Input for next layer
-		lastPrediction.assign(input);
+	// Returns time taken by last training in seconds
+	double getExecutionTime() const {
+		return executionTime;
+	}
+
+	// Returns cost at the end of last training
+	T getCost() const {
+		return cost;
+	}
+
+	// Returns cost over held out examples at the end of last training, 0 if none were held out
+	T getValidationCost() const {
+		return validationCost;
+	}
+
+	// Returns why last training stopped
+	StopReasons getStopReason() const {
+		return stopReason;
+	}
 
+	// Returns number of times the network grew over last training
+	uint getGrowthCount() const {
+		return growths;
+	}
+
+	// Returns number of times L-BFGS started again from new weights over last training
+	uint getRestartCount() const {
+		return restarts;
+	}
+
+	// Returns number of layers, excluding input
+	uint getLayerCount() const {
+		return (uint)layers.size();
+	}
+
+	// Returns reference to i-th layer
+	const Layer<T>& getLayer(uint i) const {
+		return layers[i];
+	}
+
+	/* Returns true if input can be given to this network, each row the size of the input layer
+	 * Input of an embedding must be category ids, whole numbers inside its vocabulary or negative for an empty slot
+	 */
+	bool isValidInput(const VMatrixView<T>& input) const {
+		return input.getRowLength() == layers.front().getInputSize()
+			&& layers.front().isValidInput(input.qGet(), input.getColumnLength());
+	}
+
+	// Returns number of parameters over all layers
+	uint getParameterCount() const {
+		uint total = 0;
+		for (auto& i : layers) {
+			total += i.getParameterCount();
+		}
+		return total;
+	}
+
+	// Copies parameters of all layers into a single flat vector x
+	void getParameters(T* x) const {
+		for (auto& i : layers) {
+			alg::copy(i.getParameters(), x, i.getParameterCount());
+			x += i.getParameterCount();
+		}
+	}
+
+	// Sets parameters of all layers from a single flat vector x
+	void setParameters(const T* x) {
+		for (auto& i : layers) {
+			alg::copy(x, i.getParameters(), i.getParameterCount());
+			x += i.getParameterCount();
+		}
+		compressLayers();
+	}
+
+	// Copies gradient of all layers into a single flat vector g
+	void getGradient(T* g) const {
 		for (auto& i : layers) {
-			lastPrediction.assign(i.propogateForward(lastPrediction, LRATE));
+			alg::copy(i.getGradient(), g, i.getParameterCount());
+			g += i.getParameterCount();
 		}
+	}
 
-		return lastPrediction;
+	// Gets accuracy of activation functions from hyper parameters
+	MathMode getMathMode() const {
+		return hParams.get(FAST_MATH) ? MathMode::fast : MathMode::exact;
+	}
+
+	// Updates layers to use activation functions of the current MathMode
+	void setMathMode() {
+		for (auto& i : layers) {
+			i.setMathMode(getMathMode());
+		}
+	}
+
+	// Gets loss from hyper parameters
+	LossTypes getLoss() const {
+		return (LossTypes)(int)hParams.get(LOSS);
+	}
+
+	// Cross entropy losses apply their own output function, so the output layer runs linear kernels
+	// while one is set, and its own activation function otherwise
+	void setLoss() {
+		layers.back().setFusedOutput(loss::isCrossEntropy(getLoss()), getMathMode());
+	}
+
+	// Gets normalisation of input from hyper parameters
+	NormalisationTypes getNormalisationType() const {
+		return (NormalisationTypes)(int)hParams.get(NORMALISE);
+	}
+
+	// Returns true if input is transformed before the first layer
+	bool isNormalised() const {
+		return !inputShift.empty();
+	}
+
+	// Returns statistics of input of all examples added
+	const Normaliser<T>& getInputStatistics() const {
+		return inputStatistics;
+	}
+
+	// Gets transform of input, both empty if input is used as given
+	void getNormalisation(std::vector<T>& shift, std::vector<T>& scale) const {
+		shift = inputShift;
+		scale = inputScale;
+	}
+
+	/* Sets transform of input to (x - shift) * scale, both empty for none
+	 * If keepFunction, weights and bias of the first layer are changed so the function of the network is unchanged
+	 * otherwise parameters are left as they are, as when restoring a transform saved along with them
+	 */
+	void setNormalisation(const std::vector<T>& shift, const std::vector<T>& scale, bool keepFunction = true) {
+		assert(shift.size() == scale.size() && (shift.empty() || shift.size() == layers[0].getInputSize())
+			&& "Transform must have a shift and scale for each input");
+
+		if (keepFunction) {
+			assert(layers[0].isDense() && "Only a dense first layer can take up a change of transform");
+
+			// x' = (x - s) c becomes x'' = (x - s2) c2, so x' = (x'' / c2 + s2 - s) c
+			Layer<T>& first = layers[0];
+			const uint inputs = first.getInputSize(), nodes = first.getNodeCount();
+			T* weight = first.getParameters();
+			T* bias = weight + (size_t)inputs * nodes;
+
+			for (uint i = 0; i < inputs; i++) {
+				const T s = isNormalised() ? inputShift[i] : T(0), c = isNormalised() ? inputScale[i] : T(1);
+				const T s2 = shift.empty() ? T(0) : shift[i], c2 = scale.empty() ? T(1) : scale[i];
+				T* row = weight + (size_t)i * nodes;
+				for (uint n = 0; n < nodes; n++) {
+					bias[n] += row[n] * c * (s2 - s);
+					row[n] *= c / c2;
+				}
+			}
+		}
+
+		inputShift = shift;
+		inputScale = scale;
+		clearMemoryPlans();
+	}
+
+	/* Folds transform of input into weights and bias of the first layer, which then takes input as given
+	 * so the network can be used where no transform is applied, such as StaticNetwork
+	 */
+	void foldNormalisation() {
+		setNormalisation({}, {}, true);
+	}
+
+	// Forward propogates through all layers
+	// Returns view of predicted outputs, valid until the next iteration
+	// With a cross entropy loss, outputs are z of the output layer until backward propogation
+	VMatrixView<T> forwardPropogate(const VMatrixView<T>& input) {
+		setLoss();
+		return forwardPropogate(workspace, input);
 	}
 
 	// Compute the rate of change of cost
@@ -95,43 +1172,241 @@ public:
 		return (activation - YObs) * T(2.0);
 	}
 
-	// Backwards propogation step
-	// Takes Matrix where each column is the expected output
-	// Of the ith node in the output layer
-	// And each column corresponds to a new input
-	void backwardPropogate(const VMatrix<T>& YObs) {
+	/* Backwards propogation step
+	 * Takes Matrix where each column is the expected output
+	 * Of the ith node in the output layer
+	 * And each row corresponds to a new input
+	 * Sets gradient of each layer, averaged over input
+	 * If given, the average is weighted by weights of each input
+	 * Cost is computed while setting dcda of the output layer
+	 * returns cost if evaluateCost, otherwise 0
+	 */
+	T backwardPropogate(const VMatrixView<T>& YObs, bool evaluateCost = true, const T* weights = nullptr) {
+		const T scale = T(1) / sumWeights(weights, workspace.lastInput.getColumnLength());
+		const bool embeddingRows = layers[0].getShape().kind == LayerKinds::embedding;
+		T cost = backwardPropogate(workspace, YObs, evaluateCost, scale, weights, nullptr, embeddingRows);
+		setGradient(workspace.gradient.data(), embeddingRows ? &workspace.embeddingRows : nullptr);
+		return cost;
+	}
 
-		// Iterate through backwards
-		for (uint i = (uint)layers.size(); i--;) {
-			// compute dcda
-			if (i == layers.size() - 1) {
-				layers[i].setFirstdcda(YObs);
+	/* Adds count nodes to hidden layer l, keeping the function of the network, as Net2Net widening
+	 * Each new node copies a random node of the layer, and the next layer splits the
+	 * outgoing weights of that node between it and its copy by a random share
+	 * so the two receive different gradients and can diverge
+	 */
+	void widenLayer(uint l, uint count) {
+		assert(l + 1 < layers.size() && "Only hidden layers can be widened");
+		assert(canWiden(l) && "Only dense layers followed by a dense layer, neither pruned, can be widened");
+
+		std::vector<uint> sources(count);
+		std::vector<T> shares(count);
+		for (auto& i : sources) {
+			i = rand_ex::sampleNextIndex(layers[l].getNodeCount());
+		}
+		rand_ex::sampleNextUniforms(shares.data(), count, T(0.25), T(0.75));
+
+		layers[l].insertNodes(sources);
+		layers[l + 1].insertInputs(sources, shares);
+		clearMemoryPlans();
+	}
+
+	/* Inserts a layer before layer l, keeping the function of the network, as Net2Net deepening
+	 * The new layer has as many nodes as its input, and weights start as the identity
+	 * Its activation is the identity over its input, ReLU after layers that are never negative
+	 * and linear otherwise
+	 */
+	void insertLayer(uint l) {
+		assert(l < layers.size() && "Layers are inserted before an existing layer");
+		assert((l || layers[0].getShape().kind != LayerKinds::embedding) && "An embedding must stay the first layer");
+
+		FunctionTypes type = FunctionTypes::linear;
+		if (l) {
+			switch (layers[l - 1].getFunctionType()) {
+			case FunctionTypes::sigmoid:
+			case FunctionTypes::ReLU:
+			case FunctionTypes::softplus:
+				type = FunctionTypes::ReLU;
+				break;
+
+			default:
+				break;
 			}
-			else {
-				layers[i].setdcda(layers[i + 1]);
+		}
+
+		const uint width = layers[l].getInputSize();
+		Layer<T> layer(width, width, type);
+		layer.setIdentity();
+		layer.setMathMode(getMathMode());
+		if (optimizerReady) {
+			layer.resetOptimizer(optimizer);
+		}
+		layers.insert(layers.begin() + l, std::move(layer));
+		clearMemoryPlans();
+	}
+
+	/* Grows the network, keeping its function
+	 * Inserts depth layers before the output layer, then widens each dense hidden layer by width
+	 * Layers that are pruned or not dense, and those feeding into them, keep their size
+	 * Optimizer state of existing parameters is kept, and starts at 0 for new parameters
+	 */
+	void grow(uint width, uint depth) {
+		for (uint i = 0; i < depth; i++) {
+			insertLayer((uint)layers.size() - 1);
+		}
+		if (width) {
+			for (uint l = 0; l + 1 < layers.size(); l++) {
+				if (canWiden(l)) {
+					widenLayer(l, width);
+				}
+			}
+		}
+	}
+
+	// Returns true if hidden layer l and the layer after are dense and not pruned, so l can be widened
+	bool canWiden(uint l) const {
+		return layers[l].isDense() && layers[l + 1].isDense() && !layers[l].isPruned() && !layers[l + 1].isPruned();
+	}
+
+	/* Prunes weights of smallest magnitude in dense layers, so the fraction sparsity of their weights is 0
+	 * If global, the smallest are taken over all dense layers, so layers with smaller weights lose more
+	 * otherwise each dense layer is pruned to sparsity
+	 * Weights already pruned are 0, so count towards sparsity
+	 * Bias is never pruned, and pruned weights stay 0 while training after
+	 * so the network can be fine tuned by train, and makePrediction runs pruned layers on sparse kernels
+	 */
+	void prune(double sparsity, bool global = true) {
+		// Magnitude, layer and index of each weight
+		struct Candidate {
+			T magnitude;
+			uint layer;
+			uint index;
+		};
+
+		std::vector<Candidate> candidates;
+		for (uint l = 0; l < layers.size(); l++) {
+			if (!layers[l].isDense()) {
+				continue;
+			}
+
+			const T* weight = layers[l].getParameters();
+			const uint length = layers[l].getInputSize() * layers[l].getNodeCount();
+			for (uint i = 0; i < length; i++) {
+				candidates.push_back({ (T)fabs(weight[i]), l, i });
 			}
-			layers[i].propogateBackwards();
+
+			if (!global) {
+				pruneSmallest(candidates, sparsity);
+				candidates.clear();
+			}
+		}
+
+		if (global) {
+			pruneSmallest(candidates, sparsity);
+		}
+	}
+
+	// Returns true if any layer has pruned weights
+	bool isPruned() const {
+		for (auto& i : layers) {
+			if (i.isPruned()) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	// Returns fraction of weights of dense layers that are pruned
+	double getSparsity() const {
+		uint64 pruned = 0, total = 0;
+		for (auto& i : layers) {
+			if (i.isDense()) {
+				pruned += i.getPrunedCount();
+				total += (uint64)i.getInputSize() * i.getNodeCount();
+			}
+		}
+		return total ? (double)pruned / (double)total : 0.0;
+	}
+
+	// Randomises weights of all layers with given scheme, in order from the first layer
+	void initialise(InitialisationTypes type) {
+		initialisation = type;
+		for (auto& i : layers) {
+			i.randomiseWeights(type);
+		}
+	}
+
+	// Sets optimizer from hyper parameters, and resets its state in all layers
+	void resetOptimizer() {
+		optimizer = Optimizer<T>(hParams);
+		for (auto& i : layers) {
+			i.resetOptimizer(optimizer);
+		}
+		optimizerReady = true;
+	}
+
+	// Updates parameters of all layers from gradient of last backward propogation
+	void applyGradients() {
+		optimizer.nextStep();
+		for (auto& i : layers) {
+			i.applyGradient(optimizer);
 		}
 	}
 
 	// Calculates cost given the last forward prediction
-	T computeCost(const VMatrix<T>& YObs) {
-		assert(lastPrediction.getRowLength() == YObs.getRowLength()
-			&& lastPrediction.getColumnLength() == YObs.getColumnLength()
+	// Must be called before backward propogation, which reuses prediction memory
+	T computeCost(const VMatrixView<T>& YObs) {
+		assert(layers.back().getNodeCount() == YObs.getRowLength()
+			&& workspace.lastInput.getColumnLength() == YObs.getColumnLength()
 			&& "Observation must be the same dimensions as prediction");
 
-		return (YObs - lastPrediction).apply(
-				[](T value) {
-					return pow(value, T(2));
-				}
-			).sum();
+		// Computed on a copy, as cross entropy replaces prediction with its output
+		const T* prediction = workspace.getBuffers((uint)layers.size() - 1).activation;
+		std::vector<T> output(prediction, prediction + YObs.getLength());
+		std::vector<T> dcda(YObs.getLength());
+		return loss::costAndDerivative(
+			getLoss(), output.data(), YObs.qGet(), YObs.getColumnLength(), YObs.getRowLength(), dcda.data(), true
+		);
+	}
+
+	/* Returns bytes used by each layer for training on given batch size
+	 * and the peak bytes used over an iteration, once buffers are shared
+	 * batch of 0 uses the size of the training set
+	 * Planned into a workspace of its own, so buffers in use for training are left as they are
+	 */
+	std::string memoryReport(uint batch = 0) const {
+		if (!batch) {
+			batch = seeded ? internalInput.getColumnLength() : 1;
+		}
+		Workspace report;
+		planMemory(report, batch);
+		const MemoryPlan<T>& memoryPlan = report.memoryPlan;
+
+		std::stringstream ss;
+		ss << "Memory for batch of " << batch << ":" << std::endl;
+		for (uint l = 0; l < layers.size(); l++) {
+			ss << "Layer " << l << ": " << memoryPlan.getLayerBytes(l) << " bytes of buffers, "
+				<< layers[l].getParameterBytes() << " bytes of parameters" << std::endl;
+		}
+		ss << memoryPlan.report();
+		ss << "Unshared: " << memoryPlan.getUnsharedBytes() << " bytes" << std::endl;
+		ss << "Peak per iteration: " << memoryPlan.getPoolBytes() << " bytes";
+		return ss.str();
 	}
 
 	// Sets the training set, each row is a new example
 
 
-	// Adds an example
+	/* Adds examples, each row is a new example
+	 * Statistics of input are updated in the same pass, for normalisation
+	 * With DEDUPLICATE, an example with the same bytes as one already added
+	 * increases the weight of that example instead of being stored again
+	 */
 	void addExample(const VMatrix<T>& input, const VMatrix<T>& output) {
+		assert(isValidInput(input) && "Input must be the size of the input layer, with ids inside the vocabulary of an embedding");
+		const uint rows = seeded ? internalInput.getColumnLength() : 0;
+		splitDrawn = false;
+		inputStatistics.add(input.qGet(), input.getColumnLength(), input.getRowLength());
+
 		// if not seeded, proceed to seed
 		if (!seeded) {
 			internalInput.assign(input);
@@ -142,50 +1417,364 @@ public:
 			internalInput.extend(input);
 			internalOutput.extend(output);
 		}
+
+		if (hParams.get(DEDUPLICATE) != 0.0) {
+			mergeExamples(indexStale ? 0 : rows);
+		}
+		else if (!internalWeights.empty()) {
+			internalWeights.resize(internalInput.getColumnLength(), T(1));
+			indexStale = true;
+		}
 	}
 
-	// Trains this network against internal input and output
-	void train(bool print = false) {
+	// Returns number of examples stored, repeats of an example are stored once if deduplicated
+	uint getExampleCount() const {
+		return seeded ? internalInput.getColumnLength() : 0;
+	}
 
-		// Cache some hyper parameters
+	// Returns number of examples added, counting each repeat
+	T getExampleWeight() const {
+		return internalWeights.empty() ? T(getExampleCount()) : sumWeights(internalWeights.data(), getExampleCount());
+	}
+
+	// Shuffles examples in place, keeping each input with its output
+	void shuffleExamples() {
+		shuffleExamples(internalInput.getColumnLength());
+	}
+
+	// Shuffles the first rows examples in place
+	void shuffleExamples(uint rows) {
+		for (uint i = rows; i > 1; i--) {
+			uint j = rand_ex::sampleNextIndex(i);
+			internalInput.swapRows(i - 1, j);
+			internalOutput.swapRows(i - 1, j);
+			if (!internalWeights.empty()) {
+				std::swap(internalWeights[i - 1], internalWeights[j]);
+			}
+		}
+		indexStale = true;
+	}
+
+	/* Evaluates cost over input and output with parameters x
+	 * Sets g to gradient, returns cost averaged over examples
+	 * If given, the average is weighted by weights
+	 */
+	T evaluate(const VMatrixView<T>& input, const VMatrixView<T>& output, const T* x, T* g, const T* weights = nullptr) {
+		setParameters(x);
+		forwardPropogate(input);
+		T c = backwardPropogate(output, true, weights);
+		getGradient(g);
+		return c / sumWeights(weights, input.getColumnLength());
+	}
+
+	// Evaluates cost over the whole training set with parameters x
+	T evaluate(const T* x, T* g) {
+		return evaluate(internalInput, internalOutput, x, g, internalWeights.empty() ? nullptr : internalWeights.data());
+	}
+
+	/* Trains full batch with L-BFGS
+	 * Parameters of all layers are treated as a single flat vector
+	 * Each iteration searches along the L-BFGS direction
+	 * halving step until the Armijo condition is met
+	 * With LBFGS_RESTARTS set, once no progress can be made, or cost stops falling for LBFGS_STALL iterations,
+	 * starts again from weights randomised with the last scheme, up to LBFGS_RESTARTS times
+	 * Parameters with the lowest cost over all attempts are kept, so weights given in are only replaced by better ones
+	 * Pruned networks never restart, as that would lose which weights are pruned
+	 * If given, each example is weighted by weights
+	 */
+	void trainLBFGS(const VMatrixView<T>& input, const VMatrixView<T>& output, const T* weights, bool print) {
 		const double CTHRESH = hParams.get(CONVERGENCE_THRESHOLD);
 		const uint ITERMAX = (uint)hParams.get(ITERATION_MAX);
-		const double LRATE = hParams.get(LEARNING_RATE);
+		const uint HISTORY = (uint)hParams.get(LBFGS_HISTORY);
+		const double MAXSTEP = hParams.get(LBFGS_MAX_STEP);
+		const uint RESTARTLIMIT = isPruned() ? 0 : (uint)hParams.get(LBFGS_RESTARTS);
+		const uint STALL = (uint)hParams.get(LBFGS_STALL);
+
+		const uint length = getParameterCount();
+		const T examples = sumWeights(weights, input.getColumnLength());
+		std::vector<T> x(length), g(length), d(length), xNext(length), gNext(length), ds(length), dy(length);
+		LBFGS<T> lbfgs(length, HISTORY);
 
-		// Prepare updated variables
-		cost = T(CTHRESH + T(1));
 		count = 0;
+		epochs = 0;
+		stopReason = StopReasons::none;
 
 		stopwatch::tic();
 
-		while (cost > CTHRESH && count < ITERMAX) {
-			// capture activation from forward propogation
-			VMatrix<T> activations = forwardPropogate(internalInput, LRATE);
-			cost = computeCost(internalOutput);
+		getParameters(x.data());
+		T f = evaluate(input, output, x.data(), g.data(), weights);
+		cost = f * examples;
 
-			if (print && !(count % 10000)) {
-				std::cout << "Cost: " << cost << " Left: " << ITERMAX - count << std::endl;
+		// Cost to fall below, and iterations since it was set
+		T stallCost = cost;
+		uint sinceFall = 0;
+
+		// Parameters and cost of the best attempt before the current one
+		std::vector<T> best;
+		T bestCost = std::numeric_limits<T>::infinity();
+
+		// Starts again from new weights, returns false once no restarts are left
+		auto restart = [&]() {
+			if (restarts >= RESTARTLIMIT || !std::isfinite((double)cost)) {
+				return false;
+			}
+			if (cost < bestCost) {
+				best = x;
+				bestCost = cost;
+			}
+			restarts++;
+			initialise(initialisation);
+			getParameters(x.data());
+			f = evaluate(input, output, x.data(), g.data(), weights);
+			cost = f * examples;
+			stallCost = cost;
+			sinceFall = 0;
+			lbfgs.clear();
+			return true;
+		};
+
+		while (cost > CTHRESH && count < ITERMAX && !isCancelled()) {
+			// At a stationary point, no further progress possible
+			if (!(kernels::dot(g.data(), g.data(), length) > T(1e-24))) {
+				if (restart()) {
+					continue;
+				}
+				stopReason = std::isfinite((double)cost) ? StopReasons::plateau : StopReasons::diverged;
+				break;
+			}
+
+			lbfgs.direction(g.data(), d.data());
+			T slope = kernels::dot(g.data(), d.data(), length);
+
+			// Not a descent direction, restart from steepest descent
+			if (!(slope < T(0))) {
+				lbfgs.clear();
+				lbfgs.direction(g.data(), d.data());
+				slope = kernels::dot(g.data(), d.data(), length);
+			}
+
+			// Step is limited to length MAXSTEP, which stops it jumping to where activations saturate
+			const T norm = sqrt(kernels::dot(d.data(), d.data(), length));
+			T step = (std::min)(T(1), T(MAXSTEP) / norm);
+
+			bool found = false;
+			T fNext = f;
+			for (uint i = 0; i < LBFGS<T>::LINE_SEARCH_MAX && !found; i++, step *= T(0.5)) {
+				for (uint k = 0; k < length; k++) {
+					xNext[k] = x[k] + step * d[k];
+				}
+				fNext = evaluate(input, output, xNext.data(), gNext.data(), weights);
+				found = fNext <= f + T(LBFGS<T>::ARMIJO) * step * slope;
+			}
+
+			if (!found) {
+				// Already steepest descent, no further progress possible
+				if (!lbfgs.size()) {
+					if (restart()) {
+						continue;
+					}
+					stopReason = StopReasons::plateau;
+					break;
+				}
+				lbfgs.clear();
+				continue;
+			}
+
+			for (uint k = 0; k < length; k++) {
+				ds[k] = xNext[k] - x[k];
+				dy[k] = gNext[k] - g[k];
 			}
+			lbfgs.update(ds.data(), dy.data());
 
-			// Apply an interation of backprop
-			backwardPropogate(internalOutput);
+			std::swap(x, xNext);
+			std::swap(g, gNext);
+			f = fNext;
+			cost = f * examples;
+
+			if (print && !(count % 100)) {
+				std::cout << "Cost: " << cost << " Left: " << ITERMAX - count << std::endl;
+			}
 
 			count++;
+
+			if (cost < stallCost * T(1 - LBFGS<T>::STALL_FALL)) {
+				stallCost = cost;
+				sinceFall = 0;
+			}
+			else if (STALL && ++sinceFall >= STALL && cost > CTHRESH) {
+				restart();
+			}
 		}
 
-		executionTime = stopwatch::tocGet();
+		// Keep last accepted parameters, unless an earlier attempt was better
+		if (!best.empty() && !(cost <= bestCost)) {
+			std::swap(x, best);
+			cost = bestCost;
+		}
+		setParameters(x.data());
 
-		// Set convergence flag
+		epochs = count;
+		executionTime = stopwatch::tocGet();
 		converged = cost < CTHRESH;
+		setStopReason(ITERMAX);
+	}
+
+	// Trains this network against internal input and output
+	void train(bool print = false) {
+		trainExamples(internalInput, internalOutput, true, print);
+		compressLayers();
+	}
+
+	/* Trains this network against input and output owned by caller
+	 * Examples are only read, so may be shared by many networks training at once
+	 */
+	void train(const VMatrixView<T>& input, const VMatrixView<T>& output, bool print = false) {
+		assert(isValidInput(input) && "Input must be the size of the input layer, with ids inside the vocabulary of an embedding");
+		trainExamples(input, output, false, print);
+		compressLayers();
+	}
+
+	/* Continues training from current parameters on input and output owned by caller
+	 * Runs up to iterations batches of BATCH_SIZE, cycling over examples in order
+	 * or stops once timeLimit seconds have passed, if timeLimit is positive
+	 * Optimizer state, iterations, epochs and execution time carry on from previous training
+	 * and examples are not kept, so the network can be updated from a stream
+	 * L-BFGS and HOGWILD are full training modes, so plain gradient steps are used instead
+	 * With NORMALISE, input is normalised by statistics of the first examples given
+	 * Returns cost over the last full pass of examples, or of the last batch if there was none
+	 * If no batch runs, cost and convergence are left as they are and cost of the last training is returned
+	 */
+	T partialFit(const VMatrixView<T>& input, const VMatrixView<T>& output, uint iterations, double timeLimit = 0.0) {
+		assert(isValidInput(input) && "Input must be the size of the input layer, with ids inside the vocabulary of an embedding");
+		if (!input.getColumnLength()) {
+			return cost;
+		}
+
+		const uint BATCHSIZE = (uint)hParams.get(BATCH_SIZE);
+		const uint THREADCOUNT = (std::max)((uint)hParams.get(THREAD_COUNT), 1u);
+
+		setMathMode();
+		setLoss();
+
+		// Transform of input is set from the first examples seen, and kept after
+		if (getNormalisationType() != NormalisationTypes::none && !isNormalised()) {
+			normaliseFrom(input, false);
+		}
+
+		// Only a change of optimizer type clears its state
+		const Optimizer<T> configured(hParams);
+		if (!optimizerReady || configured.getType() != optimizer.getType()) {
+			resetOptimizer();
+		}
+		else {
+			optimizer.setHParams(hParams);
+		}
+
+		const uint examples = input.getColumnLength();
+		const uint batchSize = BATCHSIZE && BATCHSIZE < examples ? BATCHSIZE : examples;
+
+		WorkerGroup group(THREADCOUNT);
+		workers.resize(THREADCOUNT);
+
+		stopReason = StopReasons::iterationMax;
+		stopwatch::tic();
+
+		// Cost of current pass, and of the last batch
+		T passCost = T(0), batchCost = T(0);
+		uint start = 0, passes = 0, batches = 0;
+		for (; batches < iterations; batches++) {
+			if (isCancelled()) {
+				stopReason = StopReasons::cancelled;
+				break;
+			}
+			if (timeLimit > 0.0 && stopwatch::tocGet() >= timeLimit) {
+				stopReason = StopReasons::timeLimit;
+				break;
+			}
+
+			const uint size = (std::min)(batchSize, examples - start);
+			if (THREADCOUNT > 1) {
+				batchCost = propogateParallel(group, input.getRows(start, size), output.getRows(start, size), true);
+			}
+			else {
+				forwardPropogate(input.getRows(start, size));
+				batchCost = backwardPropogate(output.getRows(start, size), true);
+			}
+			applyGradients();
+			count++;
+
+			passCost += batchCost;
+			start += size;
+			if (start >= examples) {
+				cost = passCost;
+				passCost = T(0);
+				start = 0;
+				passes++;
+				epochs++;
+			}
+		}
+
+		compressLayers();
+		executionTime += stopwatch::tocGet();
+
+		// Cost and convergence are only updated if a batch was evaluated
+		if (batches) {
+			if (!passes) {
+				cost = batchCost;
+			}
+			converged = cost < T(hParams.get(CONVERGENCE_THRESHOLD));
+			if (!std::isfinite((double)cost)) {
+				stopReason = StopReasons::diverged;
+			}
+		}
+		setStopReason(iterations);
+		return cost;
+	}
+
+	/* Makes prediction with given input, using caller supplied scratch space
+	 * Only reads weights, so many threads can make predictions at once
+	 * Each row of input is an input, and each row of return the corresponding output
+	 */
+	VMatrix<T> makePrediction(const VMatrix<T>& input, InferenceScratch& scratch) const {
+		assert(isValidInput(input) && "Input must be the size of the input layer, with ids inside the vocabulary of an embedding");
+
+		const MathMode mode = getMathMode();
+		const uint batch = input.getColumnLength();
+		VMatrix<T> output(layers.back().getNodeCount(), batch, T(0.0));
+
+		// Intermediate activations alternate between scratch buffers
+		const T* next = input.qGet();
+		if (isNormalised()) {
+			scratch.input.resize(input.getLength());
+			kernels::normalise(next, batch, input.getRowLength(), inputShift.data(), inputScale.data(), scratch.input.data());
+			next = scratch.input.data();
+		}
+		for (uint i = 0; i < layers.size(); i++) {
+			T* out = output.qGet();
+			if (i + 1 < layers.size()) {
+				std::vector<T>& buffer = scratch.buffers[i % 2];
+				buffer.resize((size_t)layers[i].getNodeCount() * batch);
+				out = buffer.data();
+			}
+
+			scratch.scratch.resize(layers[i].getScratchSize(batch));
+			const bool fused = i + 1 == layers.size() && loss::isCrossEntropy(getLoss());
+			layers[i].infer(next, batch, out, mode, scratch.scratch.data(), fused);
+			next = out;
+		}
+
+		loss::applyOutput(getLoss(), output.qGet(), batch, layers.back().getNodeCount());
+		return output;
 	}
 
-	// Makes prediction with given input
-	VMatrix<T> makePrediction(const VMatrix<T>& input) {
-		return forwardPropogate(input, T(0.0));
+	// Makes prediction with given input, using thread local scratch space
+	VMatrix<T> makePrediction(const VMatrix<T>& input) const {
+		thread_local InferenceScratch scratch;
+		return makePrediction(input, scratch);
 	}
 
 	// Makes prediction with nice output
-	void predict(const VMatrix<T>& input) {
+	void predict(const VMatrix<T>& input) const {
 		std::cout << "Input:" << std::endl;
 		std::cout << input.transpose() << std::endl;
 		std::cout << "output:" << std::endl;
@@ -199,8 +1788,9 @@ static std::ostream& operator<<(std::ostream& os, const Network<T>& n)
 	std::cout << "NETWORK of " << n.layers.size() << " layers" << std::endl;
 	std::cout << "Converged: " << (n.converged ? "TRUE" : "FALSE")
 		<< " IN " << n.executionTime << " seconds" << std::endl;
-	std::cout << "Iterations: " << n.count << std::endl;
+	std::cout << "Iterations: " << n.count << " Epochs: " << n.epochs << std::endl;
 	std::cout << "Perf: Its/second " << n.count / n.executionTime << std::endl;
+	std::cout << "Stopped: " << STOP_REASONS_TO_NAME.at(n.stopReason) << std::endl;
 	std::cout << "Cost: " << n.cost;
 	return os;
 }
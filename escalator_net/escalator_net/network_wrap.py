@@ -1,7 +1,7 @@
 # Provdes interface for generating escalator networks
 
-from e_net_engine import Network_create, Network_delete, Network_setHyperParameter, Network_get, Network_addExamples, Network_train, Network_predict, version
-from enumerations import FunctionTypes, Parameters
+from e_net_engine import Network_create, Network_delete, Network_setHyperParameter, Network_initialise, Network_get, Network_addExamples, Network_train, Network_partialFit, Network_predict, Network_sweep, version
+from enumerations import FunctionTypes, InitialisationTypes, Parameters
 
 class Network :
     '''
@@ -35,6 +35,13 @@ class Network :
         '''
         Network_setHyperParameter(self._netPtr, parameter.value, value)
 
+    def initialise(self, initialisationtype) :
+        '''
+        Randomises all weights with given InitialisationTypes scheme
+        Biases are set to 0
+        '''
+        Network_initialise(self._netPtr, initialisationtype.value)
+
     def _validate(self) :
         print(Network_get(self._netPtr))
 
@@ -56,6 +63,16 @@ class Network :
         '''
         Network_train(self._netPtr)
 
+    def partial_fit(self, count, input, output, iterations, timelimit = 0.0) :
+        '''
+        Continues training from current weights on given examples, which are not kept
+        Runs iterations batches, or until timelimit seconds if positive
+        Optimizer state and iteration counts carry on from previous training
+
+        Returns cost over the last pass of examples
+        '''
+        return Network_partialFit(self._netPtr, count, input, output, iterations, timelimit)
+
     def predict(self, arg1, arg2 = None) :
         '''
         Make a prediction with given data
@@ -73,4 +90,17 @@ class Network :
             return Network_predict(self._netPtr, 1, arg1)
         else :
             return Network_predict(self._netPtr, arg1, arg2)
-        
\ No newline at end of file
+
+def sweep(nodeCount, runs, count, input, output, keep = 1, threads = 1, parameters = None) :
+    '''
+    Trains a run of a network for each of runs, sharing the training data
+    Each run is a tuple (seed, learning rate, FunctionTypes)
+    Remaining runs are cancelled once keep runs converge, 0 runs all
+    parameters is an optional dict of Parameters to value, applied to all runs
+
+    Returns a list of dicts of results of each run, best first
+    '''
+    runs = [(seed, learningrate, functiontype.value) for (seed, learningrate, functiontype) in runs]
+    if parameters is not None :
+        parameters = {parameter.value : float(value) for (parameter, value) in parameters.items()}
+    return Network_sweep(nodeCount, runs, count, input, output, keep, threads, parameters)
\ No newline at end of file
@@ -0,0 +1,96 @@
+/* Benchmark of input normalisation
+ * Trains on a set whose features differ in scale and offset by orders of magnitude
+ * with inputs as given, standardised and scaled to range, each at its best learning rate */
+#ifndef __NORMALISATION_BENCHMARK__
+#define __NORMALISATION_BENCHMARK__
+
+#include <math.h>
+
+#include <iostream>
+
+#include "network.hpp"
+
+namespace tests {
+	const uint NB_INPUTS = 4;
+	const uint NB_EXAMPLES = 512;
+	const uint NB_ITERATIONS = 10000;
+
+	// Scale and offset applied to each feature, drawn from [-1, 1]
+	const double NB_SCALES[NB_INPUTS] = { 1000.0, 0.001, 1.0, 10.0 };
+	const double NB_OFFSETS[NB_INPUTS] = { 5000.0, 0.0, 200.0, -50.0 };
+
+	// Learning rates tried for each type of normalisation
+	const std::vector<double> NB_LEARNING_RATES = { 10.0, 3.0, 1.0, 0.3, 0.1, 0.01, 1e-3, 1e-4 };
+
+	/* Generates examples from features in [-1, 1], then scaled and offset
+	 * Output is 1 where the sum of the first three features is above 0
+	 */
+	void nb_generate(VMatrix<double>& input, VMatrix<double>& output) {
+		input.qFill(NB_INPUTS, NB_EXAMPLES, 0.0);
+		output.qFill(1, NB_EXAMPLES, 0.0);
+		rand_ex::seed(11);
+		for (uint j = 0; j < NB_EXAMPLES; j++) {
+			double sum = 0.0;
+			for (uint i = 0; i < NB_INPUTS; i++) {
+				const double x = rand_ex::sampleNextUniform(-1.0, 1.0);
+				sum += i < 3 ? x : 0.0;
+				input.set(i, j, x * NB_SCALES[i] + NB_OFFSETS[i]);
+			}
+			output.set(0, j, sum > 0.0 ? 1.0 : 0.0);
+		}
+		rand_ex::reset();
+	}
+
+	/* Trains from the same weights at each learning rate
+	 * and prints the run that converged in fewest iterations, or the lowest cost if none did
+	 */
+	void nb_compare(NormalisationTypes type, const VMatrix<double>& input, const VMatrix<double>& output) {
+		bool bestConverged = false;
+		uint bestIterations = 0;
+		double bestRate = 0.0, bestTime = 0.0, bestCost = 0.0;
+
+		for (double learningRate : NB_LEARNING_RATES) {
+			rand_ex::reset();
+			Network<double> net(NB_INPUTS, FunctionTypes::sigmoid, { 8, 1 }, learningRate);
+			net.getHParams().set(NORMALISE, (double)type);
+			net.getHParams().set(CONVERGENCE_THRESHOLD, 10.0);
+			net.getHParams().set(ITERATION_MAX, NB_ITERATIONS);
+			net.getHParams().set(LOSS, (double)LossTypes::sigmoidCrossEntropy);
+
+			net.addExample(input, output);
+			net.train();
+
+			const bool converged = net.isConverged();
+			const bool better = converged
+				? !bestConverged || net.getIterations() < bestIterations
+				: !bestConverged && (bestRate == 0.0 || net.getCost() < bestCost);
+			if (better) {
+				bestConverged = converged;
+				bestIterations = net.getIterations();
+				bestRate = learningRate;
+				bestTime = net.getExecutionTime();
+				bestCost = net.getCost();
+			}
+		}
+
+		std::string name = NORMALISATION_TYPES_TO_NAME.at(type);
+		name.resize(8, ' ');
+		std::cout << "  " << name
+			<< (bestConverged ? " converged" : " failed   ") << " in " << bestIterations << " iterations, " << bestTime
+			<< "s, learning rate " << bestRate << ", cost " << bestCost << std::endl;
+	}
+
+	/* Runs all benchmarks
+	 */
+	void runNormalisationBenchmark() {
+		VMatrix<double> input(1, 1, 0.0), output(1, 1, 0.0);
+		nb_generate(input, output);
+
+		std::cout << "Generated " << NB_EXAMPLES << ", features scaled from 0.001 to 1000:" << std::endl;
+		nb_compare(NormalisationTypes::none, input, output);
+		nb_compare(NormalisationTypes::standard, input, output);
+		nb_compare(NormalisationTypes::range, input, output);
+	}
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,155 @@
+/* Normalisation of inputs
+ * Statistics of each feature are gathered in a single streaming pass as examples are added
+ * and turned into a transform (x - shift) * scale, applied to input of the first layer
+ */
+#ifndef __NORMALISER__
+#define __NORMALISER__
+
+#include <math.h>
+
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "types.hpp"
+
+// Different types of normalisation, value is used in hyper parameters
+enum class NormalisationTypes {
+	// Inputs are used as given
+	none = 0,
+	// Each feature to mean 0 and variance 1
+	standard = 1,
+	// Each feature from its minimum and maximum to [0, 1]
+	range = 2,
+};
+
+// Map of NormalisationTypes to string name
+const std::map<NormalisationTypes, std::string> NORMALISATION_TYPES_TO_NAME = {
+	{NormalisationTypes::none, "none"},
+	{NormalisationTypes::standard, "standard"},
+	{NormalisationTypes::range, "range"}
+};
+
+template <typename T>
+class Normaliser {
+	// Number of rows seen
+	uint64 count = 0;
+
+	/* Running mean and sum of squared deviations of each feature, by Welford's method
+	 * Kept in double, so long streams of float do not lose precision
+	 */
+	std::vector<double> mean;
+	std::vector<double> m2;
+	std::vector<double> minimum;
+	std::vector<double> maximum;
+
+public:
+	// Removes all statistics
+	void clear() {
+		count = 0;
+		mean.clear();
+		m2.clear();
+		minimum.clear();
+		maximum.clear();
+	}
+
+	// Adds statistics of rows of given width, each row is an example
+	void add(const T* rows, uint rowCount, uint width) {
+		if (!count) {
+			mean.assign(width, 0.0);
+			m2.assign(width, 0.0);
+			minimum.assign(width, std::numeric_limits<double>::infinity());
+			maximum.assign(width, -std::numeric_limits<double>::infinity());
+		}
+
+		for (uint j = 0; j < rowCount; j++) {
+			const T* row = rows + (size_t)j * width;
+			count++;
+			const double inverse = 1.0 / (double)count;
+			for (uint i = 0; i < width; i++) {
+				const double x = (double)row[i];
+				const double delta = x - mean[i];
+				mean[i] += delta * inverse;
+				m2[i] += delta * (x - mean[i]);
+				minimum[i] = (std::min)(minimum[i], x);
+				maximum[i] = (std::max)(maximum[i], x);
+			}
+		}
+	}
+
+	// Returns number of rows seen
+	uint64 getCount() const {
+		return count;
+	}
+
+	// Returns number of features, 0 before any rows are seen
+	uint getWidth() const {
+		return (uint)mean.size();
+	}
+
+	double getMean(uint i) const {
+		return mean[i];
+	}
+
+	// Returns population variance of feature i
+	double getVariance(uint i) const {
+		return count ? m2[i] / (double)count : 0.0;
+	}
+
+	double getMinimum(uint i) const {
+		return minimum[i];
+	}
+
+	double getMaximum(uint i) const {
+		return maximum[i];
+	}
+
+	/* Sets shift and scale of each feature for given type
+	 * A feature with no spread is only shifted
+	 */
+	void getTransform(NormalisationTypes type, std::vector<T>& shift, std::vector<T>& scale) const {
+		const uint width = getWidth();
+		shift.assign(width, T(0));
+		scale.assign(width, T(1));
+
+		for (uint i = 0; i < width; i++) {
+			double spread = 0.0;
+			switch (type) {
+			case NormalisationTypes::standard:
+				shift[i] = T(mean[i]);
+				spread = sqrt(getVariance(i));
+				break;
+
+			case NormalisationTypes::range:
+				shift[i] = T(minimum[i]);
+				spread = maximum[i] - minimum[i];
+				break;
+
+			default:
+				break;
+			}
+
+			if (spread > 0.0) {
+				scale[i] = T(1.0 / spread);
+			}
+		}
+	}
+};
+
+namespace kernels {
+	// Sets out to (in - shift) * scale for each row of in, of size (batch, width)
+	template <typename T>
+	void normalise(const T* in, uint batch, uint width, const T* shift, const T* scale, T* out) {
+		for (uint j = 0; j < batch; j++) {
+			const T* row = in + (size_t)j * width;
+			T* outRow = out + (size_t)j * width;
+			for (uint i = 0; i < width; i++) {
+				outRow[i] = (row[i] - shift[i]) * scale[i];
+			}
+		}
+	}
+}
+
+#endif
\ No newline at end of file
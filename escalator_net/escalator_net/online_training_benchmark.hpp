@@ -0,0 +1,81 @@
+/* Benchmark of online training
+ * Feeds the data parallel set in chunks, comparing partial fits on each new chunk
+ * against retraining on every example seen so far */
+#ifndef __ONLINE_TRAINING_BENCHMARK__
+#define __ONLINE_TRAINING_BENCHMARK__
+
+#include <iostream>
+
+#include "data_parallel_benchmark.hpp"
+
+namespace tests {
+	// Examples arriving at once
+	const uint OTB_CHUNK = 256;
+
+	// Examples in each mini batch
+	const uint OTB_BATCH = 64;
+
+	// Passes over the new, or all, examples after each chunk arrives
+	const uint OTB_PASSES = 4;
+
+	// Returns fraction of examples where prediction is on the same side of 0.5 as output
+	double otb_accuracy(const Network<double>& net, const VMatrix<double>& input, const VMatrix<double>& output) {
+		VMatrix<double> prediction = net.makePrediction(input);
+		uint correct = 0;
+		for (uint j = 0; j < output.getColumnLength(); j++) {
+			correct += (prediction.qGet(j) > 0.5) == (output.qGet(j) > 0.5);
+		}
+		return (double)correct / output.getColumnLength();
+	}
+
+	// Creates network trained by each method from the same weights
+	Network<double> otb_create() {
+		rand_ex::reset();
+		Network<double> net(DPB_INPUTS, FunctionTypes::tanH, { 16, 1 }, 0.02);
+		net.initialise(InitialisationTypes::xavier);
+		net.getHParams().set(OPTIMIZER, (double)OptimizerTypes::adam);
+		net.getHParams().set(LOSS, (double)LossTypes::sigmoidCrossEntropy);
+		net.getHParams().set(BATCH_SIZE, OTB_BATCH);
+		net.getHParams().set(CONVERGENCE_THRESHOLD, 0.0);
+		return net;
+	}
+
+	/* Runs all benchmarks
+	 */
+	void runOnlineTrainingBenchmark() {
+		VMatrix<double> input(1, 1, 0.0), output(1, 1, 0.0);
+		dpb_generate(input, output);
+		const VMatrixView<double> inputView(input), outputView(output);
+
+		Network<double> partial = otb_create();
+		Network<double> retrain = otb_create();
+		double retrainTime = 0.0;
+
+		for (uint start = 0; start < DPB_EXAMPLES; start += OTB_CHUNK) {
+			const VMatrixView<double> chunkInput = inputView.getRows(start, OTB_CHUNK);
+			const VMatrixView<double> chunkOutput = outputView.getRows(start, OTB_CHUNK);
+
+			partial.partialFit(chunkInput, chunkOutput, OTB_PASSES * OTB_CHUNK / OTB_BATCH);
+
+			retrain.addExample(chunkInput.copy(), chunkOutput.copy());
+			retrain.getHParams().set(ITERATION_MAX, OTB_PASSES * (start + OTB_CHUNK) / OTB_BATCH);
+			retrain.train();
+			retrainTime += retrain.getExecutionTime();
+		}
+
+		std::cout << "Partial fit: " << partial.getExecutionTime() << "s, " << partial.getIterations()
+			<< " iterations, accuracy " << otb_accuracy(partial, input, output) << std::endl;
+		std::cout << "Retrain:     " << retrainTime << "s, accuracy " << otb_accuracy(retrain, input, output) << std::endl;
+
+		// Fitting no examples, or for no iterations, leaves the network as it is
+		const uint iterations = partial.getIterations();
+		const double cost = partial.getCost();
+		const bool converged = partial.isConverged();
+		partial.partialFit(inputView.getRows(0, 0), outputView.getRows(0, 0), OTB_PASSES);
+		partial.partialFit(inputView, outputView, 0);
+		std::cout << "Empty fit:   " << partial.getIterations() - iterations << " iterations, cost and convergence "
+			<< (cost == partial.getCost() && converged == partial.isConverged() ? "kept" : "changed") << std::endl;
+	}
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,198 @@
+/* Optimizers that update parameters from their gradient
+ * Each keeps per parameter state, stored by the layer after its gradient
+ */
+#ifndef __OPTIMIZER__
+#define __OPTIMIZER__
+
+#include <math.h>
+
+#include <map>
+#include <string>
+
+#include "hyper_parameters.h"
+#include "types.hpp"
+
+// Different types of optimizer, value is used in hyper parameters
+enum class OptimizerTypes {
+	SGD = 0,
+	momentum = 1,
+	nesterov = 2,
+	RMSProp = 3,
+	adam = 4,
+	// Trains full batch with L-BFGS rather than updating each step
+	LBFGS = 5,
+};
+
+// Map of OptimizerTypes to string name
+const std::map<OptimizerTypes, std::string> OPTIMIZER_TYPES_TO_NAME = {
+	{OptimizerTypes::SGD, "SGD"},
+	{OptimizerTypes::momentum, "momentum"},
+	{OptimizerTypes::nesterov, "nesterov"},
+	{OptimizerTypes::RMSProp, "RMSProp"},
+	{OptimizerTypes::adam, "adam"},
+	{OptimizerTypes::LBFGS, "L-BFGS"}
+};
+
+namespace kernels {
+	// p = p - lr g
+	template <typename T>
+	void sgdStep(T* p, const T* g, uint length, T lr) {
+		for (uint i = 0; i < length; i++) {
+			p[i] -= lr * g[i];
+		}
+	}
+
+	// v = mu v + g, p = p - lr v
+	template <typename T>
+	void momentumStep(T* p, const T* g, T* v, uint length, T lr, T mu) {
+		for (uint i = 0; i < length; i++) {
+			const T vi = mu * v[i] + g[i];
+			v[i] = vi;
+			p[i] -= lr * vi;
+		}
+	}
+
+	// v = mu v + g, p = p - lr (g + mu v)
+	template <typename T>
+	void nesterovStep(T* p, const T* g, T* v, uint length, T lr, T mu) {
+		for (uint i = 0; i < length; i++) {
+			const T vi = mu * v[i] + g[i];
+			v[i] = vi;
+			p[i] -= lr * (g[i] + mu * vi);
+		}
+	}
+
+	// s = b2 s + (1 - b2) g^2, p = p - lr g / (sqrt(s) + eps)
+	template <typename T>
+	void rmsPropStep(T* p, const T* g, T* s, uint length, T lr, T b2, T eps) {
+		for (uint i = 0; i < length; i++) {
+			const T gi = g[i];
+			const T si = b2 * s[i] + (T(1) - b2) * gi * gi;
+			s[i] = si;
+			p[i] -= lr * gi / (sqrt(si) + eps);
+		}
+	}
+
+	/* m = b1 m + (1 - b1) g, v = b2 v + (1 - b2) g^2
+	 * p = p - alpha m / (sqrt(v) + eps)
+	 * alpha and eps have bias correction of the current step folded in
+	 */
+	template <typename T>
+	void adamStep(T* p, const T* g, T* m, T* v, uint length, T alpha, T b1, T b2, T eps) {
+		for (uint i = 0; i < length; i++) {
+			const T gi = g[i];
+			const T mi = b1 * m[i] + (T(1) - b1) * gi;
+			const T vi = b2 * v[i] + (T(1) - b2) * gi * gi;
+			m[i] = mi;
+			v[i] = vi;
+			p[i] -= alpha * mi / (sqrt(vi) + eps);
+		}
+	}
+}
+
+/* Settings for an optimizer, shared by all layers of a network
+ * Per parameter state is owned by each layer
+ */
+template <typename T>
+class Optimizer {
+	OptimizerTypes type = OptimizerTypes::SGD;
+
+	// Step size
+	T learningRate = T(1);
+
+	// Decay of first moment, or momentum
+	T beta1 = T(0.9);
+
+	// Decay of second moment
+	T beta2 = T(0.999);
+
+	// Added to denominator of adaptive steps
+	T epsilon = T(1e-8);
+
+	// Number of steps taken, for bias correction
+	uint step = 0;
+
+	// Bias corrected values for current step of adam
+	T alpha = T(1);
+	T epsilonHat = T(1e-8);
+
+public:
+	Optimizer() {
+	}
+
+	// Creates optimizer from hyper parameters
+	Optimizer(const HyperParameters& hParams)
+		: type((OptimizerTypes)(int)hParams.get(OPTIMIZER)) {
+		setHParams(hParams);
+	}
+
+	// Updates step size and decays from hyper parameters, keeping type and step count
+	void setHParams(const HyperParameters& hParams) {
+		learningRate = T(hParams.get(LEARNING_RATE));
+		beta1 = T(hParams.get(BETA1));
+		beta2 = T(hParams.get(BETA2));
+		epsilon = T(hParams.get(EPSILON));
+	}
+
+	// Returns number of state values kept per parameter
+	static uint getStateCount(OptimizerTypes type) {
+		switch (type) {
+		case OptimizerTypes::momentum:
+		case OptimizerTypes::nesterov:
+		case OptimizerTypes::RMSProp:
+			return 1;
+
+		case OptimizerTypes::adam:
+			return 2;
+
+		default:
+			return 0;
+		}
+	}
+
+	OptimizerTypes getType() const {
+		return type;
+	}
+
+	uint getStateCount() const {
+		return getStateCount(type);
+	}
+
+	// Advances to the next step, must be called once before the layers are updated
+	void nextStep() {
+		step++;
+		const T correction1 = T(1) - T(pow(beta1, step));
+		const T correction2 = sqrt(T(1) - T(pow(beta2, step)));
+		alpha = learningRate * correction2 / correction1;
+		epsilonHat = epsilon * correction2;
+	}
+
+	/* Updates length parameters p from gradient g
+	 * state is getStateCount() arrays of length, one after the other
+	 */
+	void update(T* p, const T* g, T* state, uint length) const {
+		switch (type) {
+		case OptimizerTypes::momentum:
+			kernels::momentumStep(p, g, state, length, learningRate, beta1);
+			break;
+
+		case OptimizerTypes::nesterov:
+			kernels::nesterovStep(p, g, state, length, learningRate, beta1);
+			break;
+
+		case OptimizerTypes::RMSProp:
+			kernels::rmsPropStep(p, g, state, length, learningRate, beta2, epsilon);
+			break;
+
+		case OptimizerTypes::adam:
+			kernels::adamStep(p, g, state, state + length, length, alpha, beta1, beta2, epsilonHat);
+			break;
+
+		default:
+			kernels::sgdStep(p, g, length, learningRate);
+			break;
+		}
+	}
+};
+
+#endif
\ No newline at end of file
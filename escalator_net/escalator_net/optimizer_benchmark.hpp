@@ -0,0 +1,120 @@
+/* Benchmark of optimizers, and L-BFGS training
+ * Compares iterations and time to convergence against plain gradient descent
+ * on the test networks */
+#ifndef __OPTIMIZER_BENCHMARK__
+#define __OPTIMIZER_BENCHMARK__
+
+#include <iomanip>
+#include <iostream>
+
+#include "line_trial.hpp"
+#include "network.hpp"
+
+namespace tests {
+	// Optimizer and learning rate to compare, and times L-BFGS may restart
+	struct OBOptimizer {
+		OptimizerTypes type;
+		double learningRate;
+		uint restarts = 0;
+	};
+
+	// Compared optimizers, plain gradient descent first
+	const std::vector<OBOptimizer> OB_OPTIMIZERS = {
+		{ OptimizerTypes::SGD, 1.0 },
+		{ OptimizerTypes::momentum, 0.5 },
+		{ OptimizerTypes::nesterov, 0.5 },
+		{ OptimizerTypes::RMSProp, 0.02 },
+		{ OptimizerTypes::adam, 0.05 },
+		{ OptimizerTypes::LBFGS, 1.0 },
+		{ OptimizerTypes::LBFGS, 1.0, 10 },
+	};
+
+	/* Trains a network with each optimizer from the same initial weights
+	 * and prints iterations and time to convergence
+	 */
+	void ob_compare(std::string name, uint inputWidth, FunctionTypes type, std::vector<uint> nodeCounts,
+		const VMatrix<double>& input, const VMatrix<double>& output) {
+
+		std::cout << name << ":" << std::endl;
+		for (auto& i : OB_OPTIMIZERS) {
+			rand_ex::reset();
+			Network<double> net(inputWidth, type, nodeCounts, i.learningRate);
+			net.getHParams().set(OPTIMIZER, (double)i.type);
+			net.getHParams().set(ITERATION_MAX, 200000.0);
+			net.getHParams().set(LBFGS_RESTARTS, i.restarts);
+
+			net.addExample(input, output);
+			net.train();
+
+			const std::string label = OPTIMIZER_TYPES_TO_NAME.at(i.type) + (i.restarts ? " " + std::to_string(i.restarts) + " restarts" : "");
+			std::cout << "  " << std::setw(20) << std::left << label
+				<< (net.isConverged() ? "converged" : "failed") << " in " << net.getIterations()
+				<< " iterations, " << net.getExecutionTime() << "s, cost " << net.getCost() << std::endl;
+		}
+	}
+
+	/* Trains a network with adam, then carries on with L-BFGS restarting often
+	 * Restarts throw away the trained weights, so the best attempt must be kept
+	 */
+	void ob_restartKeepsBest(const VMatrix<double>& input, const VMatrix<double>& output) {
+		rand_ex::reset();
+		Network<double> net(2, FunctionTypes::sigmoid, { 2, 2, 1 }, 0.05);
+		net.getHParams().set(OPTIMIZER, (double)OptimizerTypes::adam);
+		net.getHParams().set(ITERATION_MAX, 200000.0);
+		net.addExample(input, output);
+		net.train();
+		const double trained = net.getCost();
+
+		net.getHParams().set(OPTIMIZER, (double)OptimizerTypes::LBFGS);
+		net.getHParams().set(CONVERGENCE_THRESHOLD, 0.0);
+		net.getHParams().set(ITERATION_MAX, 300.0);
+		net.getHParams().set(LBFGS_STALL, 5.0);
+		net.getHParams().set(LBFGS_RESTARTS, 5.0);
+		net.train();
+
+		std::cout << "L-BFGS after adam: cost " << trained << " to " << net.getCost()
+			<< " over " << net.getRestartCount() << " restarts, "
+			<< (net.getCost() <= trained ? "kept best" : "lost trained weights") << std::endl;
+	}
+
+	/* Runs all benchmarks
+	 */
+	void runOptimizerBenchmark() {
+		VMatrix<double> input(
+			{
+				{0.0, 0.0},
+				{0.0, 1.0},
+				{1.0, 0.0},
+				{1.0, 1.0}
+			}
+		);
+
+		VMatrix<double> xorOutput(
+			{
+				{0.0},
+				{1.0},
+				{1.0},
+				{0.0}
+			}
+		);
+
+		VMatrix<double> nxorOutput(
+			{
+				{1.0},
+				{0.0},
+				{0.0},
+				{1.0}
+			}
+		);
+
+		ob_compare("XOR Gate", 2, FunctionTypes::sigmoid, { 2, 1 }, input, xorOutput);
+		ob_compare("NXOR Gate", 2, FunctionTypes::softplus, { 2, 1 }, input, nxorOutput);
+		ob_compare("XOR Deep Gate", 2, FunctionTypes::sigmoid, { 2, 2, 1 }, input, xorOutput);
+		ob_restartKeepsBest(input, xorOutput);
+
+		LineTrialMaster master = lt_getMaster();
+		ob_compare("Line trial", 16, FunctionTypes::sigmoid, { 4, 2 }, master.getInput(16), master.getOutput(2));
+	}
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,137 @@
+/* Benchmark of magnitude pruning
+ * Prunes a trained network with wide hidden layers to a range of sparsity
+ * and prints prediction latency on sparse kernels and accuracy, before and after fine tuning */
+#ifndef __PRUNING_BENCHMARK__
+#define __PRUNING_BENCHMARK__
+
+#include <math.h>
+
+#include <iomanip>
+#include <iostream>
+
+#include "network.hpp"
+
+namespace tests {
+	const uint PB_INPUTS = 16;
+	const uint PB_CLASSES = 4;
+	const uint PB_WIDTH = 128;
+	const uint PB_EXAMPLES = 1024;
+
+	// Iterations of training, and of fine tuning after pruning
+	const uint PB_ITERATIONS = 400;
+	const uint PB_TUNE_ITERATIONS = 100;
+
+	// Times each prediction is repeated to measure latency
+	const uint PB_REPEATS = 20;
+
+	/* Generates examples of random input, the class of each is the largest of
+	 * PB_CLASSES random projections of input, drawn from the same seed for each set
+	 */
+	void pb_generate(uint seed, VMatrix<double>& input, VMatrix<double>& output) {
+		input.qFill(PB_INPUTS, PB_EXAMPLES, 0.0);
+		output.qFill(PB_CLASSES, PB_EXAMPLES, 0.0);
+
+		rand_ex::seed(3);
+		std::vector<double> projection(PB_INPUTS * PB_CLASSES);
+		rand_ex::sampleNextUniforms(projection.data(), PB_INPUTS * PB_CLASSES, -1.0, 1.0);
+
+		rand_ex::seed(seed);
+		rand_ex::sampleNextUniforms(input.qGet(), input.getLength(), -1.0, 1.0);
+		for (uint j = 0; j < PB_EXAMPLES; j++) {
+			uint best = 0;
+			double bestValue = -INFINITY;
+			for (uint c = 0; c < PB_CLASSES; c++) {
+				double z = 0.0;
+				for (uint i = 0; i < PB_INPUTS; i++) {
+					z += input.get(i, j) * projection[i * PB_CLASSES + c];
+				}
+				best = z > bestValue ? c : best;
+				bestValue = (std::max)(z, bestValue);
+			}
+			output.set(best, j, 1.0);
+		}
+		rand_ex::reset();
+	}
+
+	// Returns fraction of examples where the largest output is the expected class
+	double pb_accuracy(const Network<double>& net, const VMatrix<double>& input, const VMatrix<double>& output) {
+		VMatrix<double> prediction = net.makePrediction(input);
+		uint correct = 0;
+		for (uint j = 0; j < input.getColumnLength(); j++) {
+			uint best = 0;
+			for (uint c = 1; c < PB_CLASSES; c++) {
+				best = prediction.get(c, j) > prediction.get(best, j) ? c : best;
+			}
+			correct += output.get(best, j) > 0.5 ? 1 : 0;
+		}
+		return (double)correct / (double)input.getColumnLength();
+	}
+
+	// Returns seconds per example of predicting all of input at once
+	double pb_latency(const Network<double>& net, const VMatrix<double>& input) {
+		typename Network<double>::InferenceScratch scratch;
+		net.makePrediction(input, scratch);
+
+		stopwatch::tic();
+		for (uint r = 0; r < PB_REPEATS; r++) {
+			net.makePrediction(input, scratch);
+		}
+		return stopwatch::tocGet() / PB_REPEATS / input.getColumnLength();
+	}
+
+	// Creates the network with hyper parameters of training
+	Network<double> pb_create(uint iterations) {
+		rand_ex::reset();
+		Network<double> net(PB_INPUTS, FunctionTypes::ReLU, { PB_WIDTH, PB_WIDTH, PB_CLASSES }, 0.01);
+		net.initialise(InitialisationTypes::he);
+		net.getHParams().set(LOSS, (double)LossTypes::softmaxCrossEntropy);
+		net.getHParams().set(OPTIMIZER, (double)OptimizerTypes::adam);
+		net.getHParams().set(BATCH_SIZE, 128.0);
+		net.getHParams().set(CONVERGENCE_THRESHOLD, 0.0);
+		net.getHParams().set(ITERATION_MAX, iterations);
+		return net;
+	}
+
+	/* Prunes a copy of trained to each sparsity, then fine tunes it
+	 * and prints latency relative to the dense network and unseen accuracy
+	 */
+	void pb_prune(bool global, const Network<double>& trained, double denseLatency,
+		const VMatrix<double>& input, const VMatrix<double>& output,
+		const VMatrix<double>& testInput, const VMatrix<double>& testOutput) {
+		std::cout << (global ? "Global" : "Per layer") << " magnitude pruning:" << std::endl;
+
+		for (double sparsity : { 0.5, 0.8, 0.9, 0.95, 0.98 }) {
+			Network<double> net = trained;
+			net.prune(sparsity, global);
+			const double latency = pb_latency(net, testInput);
+			const double pruned = pb_accuracy(net, testInput, testOutput);
+
+			net.getHParams().set(ITERATION_MAX, PB_TUNE_ITERATIONS);
+			net.train(input, output);
+
+			std::cout << "  sparsity " << std::setw(4) << std::left << sparsity << " " << latency * 1e9 << "ns per prediction, speedup "
+				<< denseLatency / latency << ", unseen accuracy " << pruned << ", after fine tuning " << pb_accuracy(net, testInput, testOutput)
+				<< std::endl;
+		}
+	}
+
+	/* Runs all benchmarks
+	 */
+	void runPruningBenchmark() {
+		VMatrix<double> input(1, 1, 0.0), output(1, 1, 0.0), testInput(1, 1, 0.0), testOutput(1, 1, 0.0);
+		pb_generate(1, input, output);
+		pb_generate(2, testInput, testOutput);
+
+		Network<double> trained = pb_create(PB_ITERATIONS);
+		trained.train(input, output);
+
+		const double denseLatency = pb_latency(trained, testInput);
+		std::cout << "Dense " << PB_INPUTS << "-" << PB_WIDTH << "-" << PB_WIDTH << "-" << PB_CLASSES << ": "
+			<< denseLatency * 1e9 << "ns per prediction, unseen accuracy " << pb_accuracy(trained, testInput, testOutput) << std::endl;
+
+		pb_prune(true, trained, denseLatency, input, output, testInput, testOutput);
+		pb_prune(false, trained, denseLatency, input, output, testInput, testOutput);
+	}
+}
+
+#endif
\ No newline at end of file
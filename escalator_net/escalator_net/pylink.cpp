@@ -3,6 +3,7 @@
 #include <Python.h>
 
 #include "network.hpp"
+#include "sweep.hpp"
 
 #include "pylink_helper.h"
 
@@ -134,6 +135,27 @@ extern "C" {
 		return PY_NONE;
 	}
 
+	// Randomises weights of a network with a named initialisation scheme
+	static PyObject* Network_initialise(PyObject* self, PyObject* args) {
+		// Extract arguments
+		PyObject* networkPy;
+		char* name;
+
+		if (!PyArg_ParseTuple(args, "Os", &networkPy, &name)) {
+			return nullptr;
+		}
+
+		// Extract network
+		Network<double>* network = extractNetwork(networkPy);
+		if (!network) {
+			return nullptr;
+		}
+
+		network->initialise(initialisation::getTypeFromName(name));
+
+		return PY_NONE;
+	}
+
 	// Takes a PyCapsule and gets pointer
 	static PyObject* Network_get(PyObject* self, PyObject* capsule) {
 		Network<double>* network;
@@ -168,6 +190,11 @@ extern "C" {
 		VMatrix<double> input = convertPyObToVMatrix(numberOfRows, inputPy);
 		VMatrix<double> output = convertPyObToVMatrix(numberOfRows, outputPy);
 
+		if (!network->isValidInput(input)) {
+			PyErr_SetString(PyExc_ValueError, "Input must be the size of the input layer, with ids inside the vocabulary of an embedding");
+			return nullptr;
+		}
+
 		network->addExample(input, output);
 		
 		return networkPy;
@@ -189,6 +216,42 @@ extern "C" {
 		return o;
 	}
 
+	/* Continues training from current weights on given examples, without keeping them
+	 * Runs a number of iterations, or until a time limit in seconds if positive
+	 * Returns cost over the last pass of examples
+	 */
+	static PyObject* Network_partialFit(PyObject* self, PyObject* args) {
+		// Number of rows
+		int numberOfRows;
+		unsigned int iterations;
+		double timeLimit = 0.0;
+
+		// Input/output list as py objects
+		PyObject* networkPy;
+		PyObject* inputPy;
+		PyObject* outputPy;
+
+		if (!PyArg_ParseTuple(args, "OiOOI|d", &networkPy, &numberOfRows, &inputPy, &outputPy, &iterations, &timeLimit)) {
+			return nullptr;
+		}
+
+		// Extract network
+		Network<double>* network = extractNetwork(networkPy);
+		if (!network) {
+			return nullptr;
+		}
+
+		VMatrix<double> input = convertPyObToVMatrix(numberOfRows, inputPy);
+		VMatrix<double> output = convertPyObToVMatrix(numberOfRows, outputPy);
+
+		if (!network->isValidInput(input)) {
+			PyErr_SetString(PyExc_ValueError, "Input must be the size of the input layer, with ids inside the vocabulary of an embedding");
+			return nullptr;
+		}
+
+		return PyFloat_FromDouble(network->partialFit(input, output, iterations, timeLimit));
+	}
+
 	// Takes an input and makes a prediction
 	static PyObject* Network_predict(PyObject* self, PyObject* args) {
 		// Number of rows
@@ -204,15 +267,136 @@ extern "C" {
 
 		// Extract network
 		Network<double>* network = extractNetwork(networkPy);
+		if (!network) {
+			return nullptr;
+		}
 
 		// Extract input
 		VMatrix<double> input = convertPyObToVMatrix(numberOfRows, inputPy);
 
+		if (!network->isValidInput(input)) {
+			PyErr_SetString(PyExc_ValueError, "Input must be the size of the input layer, with ids inside the vocabulary of an embedding");
+			return nullptr;
+		}
+
 		VMatrix<double> prediction = network->makePrediction(input);
 
 		return convertVMatrixToPyOb(prediction);
 	}
 
+	/* Trains a sweep over runs of a topology
+	 * Each run is a tuple (seed, learning rate, function name)
+	 * Hyper parameters is an optional dict applied to all runs
+	 * Returns a list of dicts of results, best first
+	 */
+	static PyObject* Network_sweep(PyObject* self, PyObject* args) {
+		// Number of rows
+		int numberOfRows;
+		unsigned int keep;
+		unsigned int threads;
+
+		PyObject* nodesPy;
+		PyObject* runsPy;
+		PyObject* inputPy;
+		PyObject* outputPy;
+		PyObject* hParamsPy = nullptr;
+
+		if (!PyArg_ParseTuple(args, "OOiOOII|O", &nodesPy, &runsPy, &numberOfRows, &inputPy, &outputPy, &keep, &threads, &hParamsPy)) {
+			return nullptr;
+		}
+
+		// First count is width of input
+		int n = (int)PyList_Size(nodesPy);
+		if (n < 0) {
+			return nullptr;
+		}
+		if (n < 2) {
+			PyErr_SetString(PyExc_ValueError, "Sweep needs a width of input and at least one layer");
+			return nullptr;
+		}
+
+		std::vector<uint> counts;
+		for (int i = 0; i < n; i++) {
+			const size_t count = PyLong_AsSize_t(PyList_GetItem(nodesPy, i));
+			if (count == (size_t)-1 && PyErr_Occurred()) {
+				return nullptr;
+			}
+			counts.push_back((uint)count);
+		}
+
+		Sweep<double> sweep(counts[0], std::vector<uint>(counts.begin() + 1, counts.end()));
+		sweep.setKeep(keep);
+
+		int runCount = (int)PyList_Size(runsPy);
+		if (runCount < 0) {
+			return nullptr;
+		}
+
+		for (int i = 0; i < runCount; i++) {
+			unsigned long long seed;
+			double learningRate;
+			char* functionTypePtr;
+			if (!PyArg_ParseTuple(PyList_GetItem(runsPy, i), "Kds", &seed, &learningRate, &functionTypePtr)) {
+				return nullptr;
+			}
+
+			SweepRun run;
+			run.seed = seed;
+			run.learningRate = learningRate;
+			run.type = Functions<double>::getFunctionFromName(std::string(functionTypePtr));
+			sweep.addRun(run);
+		}
+
+		if (hParamsPy && hParamsPy != Py_None) {
+			PyObject* key;
+			PyObject* value;
+			Py_ssize_t position = 0;
+			while (PyDict_Next(hParamsPy, &position, &key, &value)) {
+				const char* name = PyUnicode_AsUTF8(key);
+				if (!name) {
+					return nullptr;
+				}
+				if (!sweep.getHParams().has(name)) {
+					PyErr_Format(PyExc_ValueError, "Unknown hyper parameter %s", name);
+					return nullptr;
+				}
+				const double number = PyFloat_AsDouble(value);
+				if (number == -1.0 && PyErr_Occurred()) {
+					return nullptr;
+				}
+				sweep.getHParams().set(name, number);
+			}
+		}
+
+		VMatrix<double> input = convertPyObToVMatrix(numberOfRows, inputPy);
+		VMatrix<double> output = convertPyObToVMatrix(numberOfRows, outputPy);
+
+		// Training does not need the interpreter, so let other python threads run
+		std::vector<SweepResult> results;
+		Py_BEGIN_ALLOW_THREADS
+		results = sweep.run(input, output, threads);
+		Py_END_ALLOW_THREADS
+
+		PyObject* list = PyList_New(results.size());
+		for (uint i = 0; i < results.size(); i++) {
+			const SweepResult& result = results[i];
+			PyList_SetItem(
+					list, (Py_ssize_t)i, Py_BuildValue("{s:K,s:d,s:s,s:O,s:O,s:I,s:d,s:d}",
+						"seed", (unsigned long long)result.run.seed,
+						"learning_rate", result.run.learningRate,
+						"function", Functions<double>::getFunctionName(result.run.type).data(),
+						"converged", result.converged ? Py_True : Py_False,
+						"cancelled", result.cancelled ? Py_True : Py_False,
+						"iterations", result.iterations,
+						"time", result.time,
+						"cost", result.cost
+					)
+				);
+		}
+
+		return list;
+	}
+
 }
 
 // Exported methods
@@ -221,10 +405,13 @@ static PyMethodDef E_NET_ENGINE_METHODS[] = {
 	{ "Network_create", (PyCFunction)Network_create, METH_VARARGS, nullptr },
 	{ "Network_delete", (PyCFunction)Network_delete, METH_O, nullptr },
 	{ "Network_setHyperParameter", (PyCFunction)Network_setHyperParameter, METH_VARARGS, nullptr },
+	{ "Network_initialise", (PyCFunction)Network_initialise, METH_VARARGS, nullptr },
 	{ "Network_get", (PyCFunction)Network_get, METH_O, nullptr },
 	{ "Network_addExamples", (PyCFunction)Network_addExamples, METH_VARARGS, nullptr },
 	{ "Network_train", (PyCFunction)Network_train, METH_O, nullptr },
+	{ "Network_partialFit", (PyCFunction)Network_partialFit, METH_VARARGS, nullptr },
 	{ "Network_predict", (PyCFunction)Network_predict, METH_VARARGS, nullptr },
+	{ "Network_sweep", (PyCFunction)Network_sweep, METH_VARARGS, nullptr },
 	{ nullptr, nullptr, 0, nullptr }
 };
 
@@ -1,17 +1,43 @@
-#include <mutex>
+#include <assert.h>
+
+#include <atomic>
+#include <thread>
 
 #include "rand_ex.hpp"
 
-std::mutex randLock;
-std::default_random_engine rGen;
+// Thread that loaded the library, which keeps stream 0
+const std::thread::id loadingThread = std::this_thread::get_id();
+
+// Stream of the next other thread to create its generator
+// so threads that are never seeded do not draw the same values
+std::atomic<uint64> nextStream(rand_ex::FIRST_THREAD_STREAM);
 
-// Engine to reset to
-std::default_random_engine fallback;
+thread_local Philox rGen(0, std::this_thread::get_id() == loadingThread ? 0 : nextStream.fetch_add(1));
 
-std::default_random_engine& rand_ex::getRandomEngine() {
+Philox& rand_ex::getGenerator() {
 	return rGen;
 }
 
 void rand_ex::reset() {
-	memcpy(&rGen, &fallback, sizeof(std::default_random_engine));
+	rGen = Philox();
+}
+
+void rand_ex::seed(uint64 value, uint64 stream) {
+	rGen = Philox(value, stream);
+}
+
+uint rand_ex::sampleNextIndex(uint n) {
+	assert(n && "Index must be sampled from a non empty range");
+	if (!n) {
+		return 0;
+	}
+
+	// Multiply shift, rejecting the low values that would bias the result
+	const uint32 threshold = (uint32)(-n) % n;
+	while (true) {
+		const uint64 product = (uint64)rGen.next() * n;
+		if ((uint32)product >= threshold) {
+			return (uint)(product >> 32);
+		}
+	}
 }
\ No newline at end of file
@@ -1,33 +1,181 @@
-/* Header for templated algorithms
-*/
+/* Header for random number generation
+ * Uses Philox4x32-10, a counter based generator, so each value only depends
+ * on seed, stream and position, and streams can be split without a shared state
+ * Each thread has its own generator, which starts at seed 0 on a stream of its own
+ * The thread that loaded the library starts on stream 0, and worker i of a WorkerGroup on stream i
+ * Other threads are given streams from FIRST_THREAD_STREAM in order of first use,
+ * which may change between runs, so those threads must be seeded for repeatable runs
+ * reset returns the calling thread to stream 0, for repeatable runs
+ */
 #ifndef __RAND_EX__
 #define __RAND_EX__
 
 #include <algorithm>
-#include <random>
+#include <type_traits>
 
 #include "types.hpp"
 
+namespace kernels {
+	// Number of blocks generated together, so rounds auto vectorise
+	const uint PHILOX_LANES = 8;
+
+	// Multiplies a and b, returning high word and setting low
+	inline uint32 mulHiLo(uint32 a, uint32 b, uint32& lo) {
+		const uint64 product = (uint64)a * b;
+		lo = (uint32)product;
+		return (uint32)(product >> 32);
+	}
+
+	/* Generates blocks of 4 words from consecutive counters, starting at counter
+	 * Stream is the high half of each counter, so streams never overlap
+	 */
+	inline void philoxBlocks(uint32* out, uint blocks, const uint32 key[2], uint64 counter, uint64 stream) {
+		const uint32 M0 = 0xD2511F53, M1 = 0xCD9E8D57;
+		const uint32 W0 = 0x9E3779B9, W1 = 0xBB67AE85;
+
+		for (uint start = 0; start < blocks; start += PHILOX_LANES) {
+			const uint lanes = (std::min)(PHILOX_LANES, blocks - start);
+
+			// Each lane holds one counter
+			uint32 x0[PHILOX_LANES], x1[PHILOX_LANES], x2[PHILOX_LANES], x3[PHILOX_LANES];
+			for (uint j = 0; j < PHILOX_LANES; j++) {
+				const uint64 c = counter + start + j;
+				x0[j] = (uint32)c;
+				x1[j] = (uint32)(c >> 32);
+				x2[j] = (uint32)stream;
+				x3[j] = (uint32)(stream >> 32);
+			}
+
+			uint32 k0 = key[0], k1 = key[1];
+			for (uint round = 0; round < 10; round++) {
+				for (uint j = 0; j < PHILOX_LANES; j++) {
+					uint32 lo0, lo1;
+					const uint32 hi0 = mulHiLo(M0, x0[j], lo0);
+					const uint32 hi1 = mulHiLo(M1, x2[j], lo1);
+					x0[j] = hi1 ^ x1[j] ^ k0;
+					x1[j] = lo1;
+					x2[j] = hi0 ^ x3[j] ^ k1;
+					x3[j] = lo0;
+				}
+				k0 += W0;
+				k1 += W1;
+			}
+
+			for (uint j = 0; j < lanes; j++) {
+				uint32* block = out + 4 * (start + j);
+				block[0] = x0[j];
+				block[1] = x1[j];
+				block[2] = x2[j];
+				block[3] = x3[j];
+			}
+		}
+	}
+}
+
+/* Philox4x32-10 generator over one stream
+ * Values are taken in order from consecutive counters
+ */
+class Philox {
+	uint32 key[2];
+	uint64 stream;
+
+	// Counter of next block to generate
+	uint64 counter = 0;
+
+	// Words of last block, and position of next unused word
+	uint32 buffer[4];
+	uint index = 4;
+
+public:
+	Philox(uint64 seed = 0, uint64 stream = 0)
+		: key{ (uint32)seed, (uint32)(seed >> 32) }, stream(stream) {
+	}
+
+	// Returns next word
+	uint32 next() {
+		if (index == 4) {
+			kernels::philoxBlocks(buffer, 1, key, counter++, stream);
+			index = 0;
+		}
+		return buffer[index++];
+	}
+
+	// Fills out with the next length words, same as calling next length times
+	void generate(uint32* out, uint length) {
+		uint i = 0;
+		for (; i < length && index < 4; i++) {
+			out[i] = buffer[index++];
+		}
+
+		const uint blocks = (length - i) / 4;
+		kernels::philoxBlocks(out + i, blocks, key, counter, stream);
+		counter += blocks;
+		i += 4 * blocks;
+
+		for (; i < length; i++) {
+			out[i] = next();
+		}
+	}
+};
+
 namespace rand_ex {
-	// Gets reference to random engine
-	std::default_random_engine& getRandomEngine();
+	// Words generated at once when filling arrays
+	const uint CHUNK = 256;
+
+	// First stream given to threads that are not workers, above any worker index
+	const uint64 FIRST_THREAD_STREAM = (uint64)1 << 32;
+
+	// Gets reference to generator of this thread
+	Philox& getGenerator();
 
-	// Reset random number generator
+	// Reset generator of this thread to seed 0 stream 0
 	void reset();
 
+	// Seeds generator of this thread, each stream of a seed is independent
+	void seed(uint64 value, uint64 stream = 0);
+
+	// Returns next integer sampled uniformly from [0, n), n must not be 0
+	uint sampleNextIndex(uint n);
+
+	// Number of words used for a value of T
+	template<typename T>
+	constexpr uint wordsPerUniform() {
+		return sizeof(T) > 4 ? 2 : 1;
+	}
+
+	// Converts words to a value in [0, 1), with as many bits as T holds
+	template<typename T>
+	T toUnit(const uint32* words) {
+		if (wordsPerUniform<T>() == 2) {
+			const uint64 bits = ((uint64)words[0] << 32 | words[1]) >> 11;
+			return T(bits * (1.0 / 9007199254740992.0));
+		}
+		else {
+			return T((words[0] >> 8) * (1.0f / 16777216.0f));
+		}
+	}
+
 	// Returns next instance of a given template
 	template<typename T>
 	T sampleNextUniform(T a, T b) {
-		std::uniform_real_distribution<T> uDist(a, b);
-		return uDist(getRandomEngine());
+		uint32 words[2];
+		getGenerator().generate(words, wordsPerUniform<T>());
+		return a + (b - a) * toUnit<T>(words);
 	}
 
-	// Sets variable of given length to fill with 
+	// Sets variable of given length to fill with
 	template<typename T>
 	void sampleNextUniforms(T* array, uint length, T a, T b) {
-		std::uniform_real_distribution<T> uDist(a, b);
-		for (uint i = 0; i < length; i++) {
-			array[i] = uDist(getRandomEngine());
+		const uint WORDS = wordsPerUniform<T>();
+		uint32 words[CHUNK];
+		Philox& generator = getGenerator();
+
+		for (uint start = 0; start < length; start += CHUNK / WORDS) {
+			const uint count = (std::min)(CHUNK / WORDS, length - start);
+			generator.generate(words, count * WORDS);
+			for (uint i = 0; i < count; i++) {
+				array[start + i] = a + (b - a) * toUnit<T>(words + i * WORDS);
+			}
 		}
 	}
 }
@@ -1,9 +1,18 @@
+import platform
+import sys
+
 from distutils.core import setup, Extension, DEBUG
 
+# Kernels are written to auto vectorise, and fast_math needs AVX2 to vectorise double
+compile_args = []
+if platform.machine().lower() in ('x86_64', 'amd64'):
+    compile_args = ['/arch:AVX2'] if sys.platform == 'win32' else ['-O3', '-mavx2', '-mfma']
+
 enet_module = Extension(
         'e_net_engine', 
         sources = ['pylink.cpp', 'rand_ex.cpp', 'stopwatch.cpp'],
-        depends = ['network_wrap.py']
+        depends = ['network_wrap.py'],
+        extra_compile_args = compile_args
     )
 
 enet_function_types = Extension(
@@ -30,7 +30,7 @@ namespace tests {
 
 
 		Layer<double> a(2, 2, FunctionTypes::ReLU);
-		std::cout << a.propogateForward(input, 1.0) << std::endl;
+		std::cout << a.propogateForward(input) << std::endl;
 	}
 
 	/* Runs all test
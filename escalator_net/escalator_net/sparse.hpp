@@ -0,0 +1,113 @@
+/* Compressed sparse row storage of pruned weights, and kernels over it
+ * Weight of size (inputSize, nodeCount) is stored transposed, a row for each node
+ * listing the inputs it still takes, so each z is a dot product over those inputs
+ * Nonzeros are summed in order of input, as the dense kernel does, so results match it
+ */
+#ifndef __SPARSE__
+#define __SPARSE__
+
+#include <vector>
+
+#include "types.hpp"
+
+template <typename T>
+struct SparseWeight {
+	// Start of each node in columns and values, with a final entry for the end
+	std::vector<uint> rowStart;
+
+	// Input and weight of each nonzero, node by node
+	std::vector<uint> columns;
+	std::vector<T> values;
+
+	// Builds from weight of size (inputSize, nodeCount), keeping only nonzero values
+	void compress(const T* weight, uint inputSize, uint nodeCount) {
+		rowStart.assign(1, 0);
+		columns.clear();
+		values.clear();
+
+		for (uint n = 0; n < nodeCount; n++) {
+			for (uint i = 0; i < inputSize; i++) {
+				const T w = weight[(size_t)i * nodeCount + n];
+				if (w != T(0)) {
+					columns.push_back(i);
+					values.push_back(w);
+				}
+			}
+			rowStart.push_back((uint)columns.size());
+		}
+	}
+
+	void clear() {
+		rowStart.clear();
+		columns.clear();
+		values.clear();
+	}
+
+	bool empty() const {
+		return rowStart.empty();
+	}
+
+	// Returns number of nonzero weights
+	uint getNonzeroCount() const {
+		return (uint)values.size();
+	}
+
+	// Returns bytes used by the compressed weight
+	size_t getBytes() const {
+		return rowStart.size() * sizeof(uint) + columns.size() * sizeof(uint) + values.size() * sizeof(T);
+	}
+};
+
+namespace kernels {
+	/* Computes the linear combination z = XW + b with W in compressed form
+	 * input is (batch, inputSize), bias is (1, nodeCount) and z is (batch, nodeCount)
+	 * Examples are taken 4 at a time, so each index and value loaded feeds 4 independent sums
+	 */
+	template <typename T>
+	void sparseLinear(const T* input, uint batch, uint inputSize, const SparseWeight<T>& weight, const T* bias,
+		uint nodeCount, T* z) {
+		const uint* start = weight.rowStart.data();
+		const uint* columns = weight.columns.data();
+		const T* values = weight.values.data();
+
+		uint j = 0;
+		for (; j + 4 <= batch; j += 4) {
+			const T* x0 = input + (size_t)j * inputSize;
+			const T* x1 = x0 + inputSize;
+			const T* x2 = x1 + inputSize;
+			const T* x3 = x2 + inputSize;
+			T* row = z + (size_t)j * nodeCount;
+
+			for (uint n = 0; n < nodeCount; n++) {
+				T s0 = bias[n], s1 = bias[n], s2 = bias[n], s3 = bias[n];
+				for (uint k = start[n]; k < start[n + 1]; k++) {
+					const uint c = columns[k];
+					const T w = values[k];
+					s0 += x0[c] * w;
+					s1 += x1[c] * w;
+					s2 += x2[c] * w;
+					s3 += x3[c] * w;
+				}
+				row[n] = s0;
+				row[nodeCount + n] = s1;
+				row[2 * nodeCount + n] = s2;
+				row[3 * nodeCount + n] = s3;
+			}
+		}
+
+		for (; j < batch; j++) {
+			const T* x = input + (size_t)j * inputSize;
+			T* row = z + (size_t)j * nodeCount;
+
+			for (uint n = 0; n < nodeCount; n++) {
+				T sum = bias[n];
+				for (uint k = start[n]; k < start[n + 1]; k++) {
+					sum += x[columns[k]] * values[k];
+				}
+				row[n] = sum;
+			}
+		}
+	}
+}
+
+#endif
\ No newline at end of file
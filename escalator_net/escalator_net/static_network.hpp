@@ -0,0 +1,105 @@
+/* Network with layer sizes fixed at compile time
+ * Built on the statically sized Matrix, so uses no heap
+ * Intended for inference on small fixed topologies
+ */
+#ifndef __STATIC_NETWORK__
+#define __STATIC_NETWORK__
+
+#include "matrix.hpp"
+#include "network.hpp"
+
+/* A single layer of nodes with fixed sizes
+ * Weights are stored in the same layout as Layer
+ * where each row is the i-th input and each column is a node
+ */
+template <typename T, typename Act, uint IN, uint OUT>
+class StaticLayer {
+	// Weights, of size (IN, OUT)
+	Matrix<OUT, IN, T> weight = Matrix<OUT, IN, T>(T(0));
+
+	// Bias, of size (1, OUT)
+	Matrix<OUT, 1, T> bias = Matrix<OUT, 1, T>(T(0));
+
+public:
+	// Copies parameters from a layer of a dynamic network
+	// Returns false if layer is not of the same shape and activation
+	bool load(const Layer<T>& layer) {
+		if (!layer.isDense() || layer.getInputSize() != IN || layer.getNodeCount() != OUT
+			|| layer.getFunctionType() != Act::TYPE) {
+			return false;
+		}
+
+		alg::copy(layer.getWeight().qGet(), weight.qGet(), IN * OUT);
+		alg::copy(layer.getBias().qGet(), bias.qGet(), OUT);
+		return true;
+	}
+
+	// Computes activation for a single input
+	Matrix<OUT, 1, T> propogateForward(const Matrix<IN, 1, T>& input) const {
+		return (input * weight + bias).apply(
+			[](T z) {
+				return Act::template function<T>(z);
+			}
+		);
+	}
+};
+
+/* Network of layers with sizes SIZES
+ * The first size is the width of input, and the last the width of output
+ * Act is an activation policy from functions.hpp, used by all layers
+ * e.g. StaticNetwork<double, activation::Sigmoid, 16, 4, 2>
+ * Layers are too small for fast_math to vectorise, so exact policies are faster here
+ */
+template <typename T, typename Act, uint... SIZES>
+class StaticNetwork;
+
+// Network with no more layers, returns its input
+template <typename T, typename Act, uint IN>
+class StaticNetwork<T, Act, IN> {
+public:
+	static constexpr uint INPUTSIZE = IN;
+	static constexpr uint OUTPUTSIZE = IN;
+	static constexpr uint LAYER_COUNT = 0;
+
+	bool load(const Network<T>& network, uint index = 0) {
+		return index == network.getLayerCount();
+	}
+
+	Matrix<IN, 1, T> predict(const Matrix<IN, 1, T>& input) const {
+		return input;
+	}
+};
+
+// Network of a layer from IN to OUT, followed by the remaining layers
+template <typename T, typename Act, uint IN, uint OUT, uint... REST>
+class StaticNetwork<T, Act, IN, OUT, REST...> {
+	// First layer
+	StaticLayer<T, Act, IN, OUT> layer;
+
+	// Remaining layers
+	StaticNetwork<T, Act, OUT, REST...> next;
+
+public:
+	static constexpr uint INPUTSIZE = IN;
+	static constexpr uint OUTPUTSIZE = StaticNetwork<T, Act, OUT, REST...>::OUTPUTSIZE;
+	static constexpr uint LAYER_COUNT = 1 + StaticNetwork<T, Act, OUT, REST...>::LAYER_COUNT;
+
+	/* Copies weights from a trained dynamic network, from layer index onwards
+	 * Returns false if the network has a different topology or activation
+	 * or a cross entropy loss, as its output function is applied by the loss
+	 */
+	// Normalised input must be folded into the network first, see Network::foldNormalisation
+	bool load(const Network<T>& network, uint index = 0) {
+		if (index >= network.getLayerCount() || network.isNormalised() || loss::isCrossEntropy(network.getLoss())) {
+			return false;
+		}
+		return layer.load(network.getLayer(index)) && next.load(network, index + 1);
+	}
+
+	// Makes a prediction for a single input
+	Matrix<OUTPUTSIZE, 1, T> predict(const Matrix<IN, 1, T>& input) const {
+		return next.predict(layer.propogateForward(input));
+	}
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,119 @@
+/* Benchmark of StaticNetwork against Network
+ * Compares single input inference on small fixed topologies */
+#ifndef __STATIC_NETWORK_BENCHMARK__
+#define __STATIC_NETWORK_BENCHMARK__
+
+#include <atomic>
+#include <iostream>
+#include <vector>
+
+#include "static_network.hpp"
+#include "stopwatch.hpp"
+
+namespace tests {
+	// Number of single input predictions timed
+	const uint SNB_PREDICTIONS = 200000;
+
+	/* Loads network into static network S, then times and compares single input predictions
+	 */
+	template <typename S>
+	void snb_compare(std::string name, const Network<double>& net) {
+		S fixed;
+		if (!fixed.load(net)) {
+			std::cout << "Failed to load network" << std::endl;
+			return;
+		}
+
+		// Random inputs in both formats
+		const uint SAMPLES = 64;
+		std::vector<VMatrix<double>> dynamicInputs;
+		std::vector<Matrix<S::INPUTSIZE, 1, double>> staticInputs;
+		for (uint i = 0; i < SAMPLES; i++) {
+			Matrix<S::INPUTSIZE, 1, double> input(0.0);
+			rand_ex::sampleNextUniforms(input.qGet(), S::INPUTSIZE, 0.0, 1.0);
+			staticInputs.push_back(input);
+			dynamicInputs.push_back(VMatrix<double>(S::INPUTSIZE, 1, 0.0));
+			dynamicInputs.back().set(input.qGet(), S::INPUTSIZE);
+		}
+
+		// Check both agree
+		double error = 0.0;
+		for (uint i = 0; i < SAMPLES; i++) {
+			VMatrix<double> a = net.makePrediction(dynamicInputs[i]);
+			Matrix<S::OUTPUTSIZE, 1, double> b = fixed.predict(staticInputs[i]);
+			for (uint k = 0; k < S::OUTPUTSIZE; k++) {
+				error = (std::max)(error, std::abs(a.qGet(k) - b.qGet(k)));
+			}
+		}
+
+		double sink = 0.0;
+
+		stopwatch::tic();
+		for (uint i = 0; i < SNB_PREDICTIONS; i++) {
+			sink += net.makePrediction(dynamicInputs[i % SAMPLES]).qGet(0);
+		}
+		double dynamicTime = stopwatch::tocGet();
+
+		stopwatch::tic();
+		for (uint i = 0; i < SNB_PREDICTIONS; i++) {
+			sink += fixed.predict(staticInputs[i % SAMPLES]).qGet(0);
+			std::atomic_signal_fence(std::memory_order_seq_cst);
+		}
+		double staticTime = stopwatch::tocGet();
+
+		std::cout << "Network: " << 1e9 * dynamicTime / SNB_PREDICTIONS << "ns per prediction" << std::endl;
+		std::cout << name << ": " << 1e9 * staticTime / SNB_PREDICTIONS << "ns per prediction" << std::endl;
+		std::cout << "Max difference: " << error << " (" << sink << ")" << std::endl;
+	}
+
+	/* Trains an xor gate and compares inference
+	 */
+	void snb_XORGateDeep() {
+		Network<double> net(2, FunctionTypes::sigmoid, { 2, 2, 1 }, 1.0);
+
+		VMatrix<double> input(
+			{
+				{0.0, 0.0},
+				{0.0, 1.0},
+				{1.0, 0.0},
+				{1.0, 1.0}
+			}
+		);
+
+		VMatrix<double> output(
+			{
+				{0.0},
+				{1.0},
+				{1.0},
+				{0.0}
+			}
+		);
+
+		net.addExample(input, output);
+		net.train();
+
+		snb_compare<StaticNetwork<double, activation::Sigmoid, 2, 2, 2, 1>>("StaticNetwork", net);
+	}
+
+	/* Compares inference on the topology of the line trial
+	 */
+	void snb_lineTrial() {
+		Network<double> net(16, FunctionTypes::sigmoid, { 4, 2 }, 1.0);
+
+		snb_compare<StaticNetwork<double, activation::Sigmoid, 16, 4, 2>>("StaticNetwork", net);
+	}
+
+	/* Runs all benchmarks
+	 */
+	void runStaticNetworkBenchmark() {
+		std::cout << "XOR Deep Gate 2-2-2-1:" << std::endl;
+		snb_XORGateDeep();
+		std::cout << std::endl;
+
+		std::cout << "Line trial 16-4-2:" << std::endl;
+		snb_lineTrial();
+		std::cout << std::endl;
+	}
+}
+
+#endif
\ No newline at end of file
@@ -2,7 +2,7 @@
 
 #define MICROSECOND_IN_SECOND 1000000.0
 
-stopwatch::timepoint start = stopwatch::clock::now();
+thread_local stopwatch::timepoint start = stopwatch::clock::now();
 
 void stopwatch::tic() {
 	start = clock::now();
@@ -1,6 +1,6 @@
 /* Header for static timer
  * similar to Matlab style tic-toc usage 
- * No garuntee on thread safety
+ * Each thread has its own timer
  */
 #ifndef __STOPWATCH__
 #define __STOPWATCH__
@@ -0,0 +1,144 @@
+/* Trains many copies of a topology at once
+ * Each run has its own seed, learning rate and activation function
+ * and all runs share a single read only copy of the examples
+ */
+#ifndef __SWEEP__
+#define __SWEEP__
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <vector>
+
+#include "network.hpp"
+#include "worker_group.hpp"
+
+// Settings of a single run of a sweep
+struct SweepRun {
+	// Seed for initial weights
+	uint64 seed = 0;
+
+	double learningRate = 1.0;
+
+	FunctionTypes type = FunctionTypes::sigmoid;
+};
+
+// Result of a single run of a sweep
+struct SweepResult {
+	SweepRun run;
+
+	bool converged = false;
+
+	// True if stopped, or never started, as enough other runs converged
+	bool cancelled = false;
+
+	uint iterations = 0;
+
+	// Time taken training in seconds
+	double time = 0.0;
+
+	// Infinite for runs that never started, so they are ranked last
+	double cost = std::numeric_limits<double>::infinity();
+};
+
+/* Sweep over runs of a topology
+ * Runs are trained on a group of threads, each thread taking the next run
+ */
+template <typename T>
+class Sweep {
+	// Width of input, and node count of each layer
+	uint inputWidth;
+	std::vector<uint> nodeCounts;
+
+	// Hyper parameters used by all runs, learning rate is set per run
+	HyperParameters hParams;
+
+	std::vector<SweepRun> runs;
+
+	// Remaining runs are cancelled once this many converge, 0 runs all
+	uint keep = 1;
+
+public:
+	Sweep(uint inputWidth, std::vector<uint> nodeCounts)
+		: inputWidth(inputWidth), nodeCounts(nodeCounts) {
+	}
+
+	// Get a reference to hyper parameters of all runs
+	HyperParameters& getHParams() {
+		return hParams;
+	}
+
+	// Adds a run
+	void addRun(const SweepRun& run) {
+		runs.push_back(run);
+	}
+
+	// Adds a run for each seed in [first, first + count), with the same settings
+	void addSeeds(uint64 first, uint count, double learningRate, FunctionTypes type) {
+		for (uint i = 0; i < count; i++) {
+			SweepRun run;
+			run.seed = first + i;
+			run.learningRate = learningRate;
+			run.type = type;
+			runs.push_back(run);
+		}
+	}
+
+	// Sets number of runs to converge before the rest are cancelled, 0 runs all
+	void setKeep(uint keep) {
+		this->keep = keep;
+	}
+
+	/* Trains all runs on input and output, with given number of threads
+	 * Each network is created by the thread that trains it, from its own seed
+	 * so initial weights do not depend on the number of threads
+	 * Returns a result for each run, ordered by convergence and then cost
+	 */
+	std::vector<SweepResult> run(const VMatrixView<T>& input, const VMatrixView<T>& output, uint threads) {
+		std::vector<SweepResult> results(runs.size());
+		std::atomic<bool> cancel(false);
+		std::atomic<uint> next(0);
+		std::atomic<uint> convergedCount(0);
+
+		WorkerGroup group((std::max)(threads, 1u));
+		group.run(
+			[&](uint) {
+				for (uint i; (i = next.fetch_add(1)) < runs.size();) {
+					SweepResult& result = results[i];
+					result.run = runs[i];
+
+					if (cancel.load()) {
+						result.cancelled = true;
+						continue;
+					}
+
+					rand_ex::seed(runs[i].seed);
+					Network<T> network(inputWidth, runs[i].type, nodeCounts);
+					network.getHParams() = hParams;
+					network.getHParams().set(LEARNING_RATE, runs[i].learningRate);
+					network.setCancelFlag(&cancel);
+					network.train(input, output);
+
+					result.converged = network.isConverged();
+					result.cancelled = !result.converged && cancel.load();
+					result.iterations = network.getIterations();
+					result.time = network.getExecutionTime();
+					result.cost = (double)network.getCost();
+
+					if (result.converged && keep && convergedCount.fetch_add(1) + 1 >= keep) {
+						cancel.store(true);
+					}
+				}
+			}
+		);
+
+		std::stable_sort(results.begin(), results.end(),
+			[](const SweepResult& a, const SweepResult& b) {
+				return a.converged != b.converged ? a.converged : a.cost < b.cost;
+			}
+		);
+		return results;
+	}
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,66 @@
+/* Benchmark of sweeps
+ * Trains many seeds and learning rates of the deep XOR gate
+ * and compares running all runs against stopping at the first to converge */
+#ifndef __SWEEP_BENCHMARK__
+#define __SWEEP_BENCHMARK__
+
+#include <iomanip>
+#include <iostream>
+
+#include "stopwatch.hpp"
+#include "sweep.hpp"
+
+namespace tests {
+	// Number of seeds in each sweep
+	const uint SB_RUNS = 8;
+
+	/* Runs a sweep of the deep XOR gate, and prints each result
+	 */
+	void sb_sweep(uint keep, uint threads, const VMatrix<double>& input, const VMatrix<double>& output) {
+		Sweep<double> sweep(2, { 2, 2, 1 });
+		sweep.getHParams().set(ITERATION_MAX, 50000.0);
+		sweep.addSeeds(1, SB_RUNS / 2, 1.0, FunctionTypes::sigmoid);
+		sweep.addSeeds(1, SB_RUNS / 2, 2.0, FunctionTypes::sigmoid);
+		sweep.setKeep(keep);
+
+		// Runs use the stopwatch of this thread, so time the sweep separately
+		const stopwatch::timepoint start = stopwatch::clock::now();
+		std::vector<SweepResult> results = sweep.run(input, output, threads);
+		const double time = std::chrono::duration<double>(stopwatch::clock::now() - start).count();
+
+		std::cout << "Keep " << keep << ", " << threads << " threads: " << time << "s" << std::endl;
+		for (auto& result : results) {
+			std::cout << "  seed " << result.run.seed << " lr " << result.run.learningRate << ": "
+				<< (result.converged ? "converged" : result.cancelled ? "cancelled" : "failed")
+				<< " in " << result.iterations << " iterations, cost " << result.cost << std::endl;
+		}
+	}
+
+	/* Runs all benchmarks
+	 */
+	void runSweepBenchmark() {
+		VMatrix<double> input(
+			{
+				{0.0, 0.0},
+				{0.0, 1.0},
+				{1.0, 0.0},
+				{1.0, 1.0}
+			}
+		);
+
+		VMatrix<double> output(
+			{
+				{0.0},
+				{1.0},
+				{1.0},
+				{0.0}
+			}
+		);
+
+		sb_sweep(0, 1, input, output);
+		sb_sweep(1, 1, input, output);
+		sb_sweep(1, 4, input, output);
+	}
+}
+
+#endif
\ No newline at end of file
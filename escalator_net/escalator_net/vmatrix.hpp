@@ -8,6 +8,7 @@
 
 #include <assert.h>
 
+#include <algorithm>
 #include <iostream>
 #include <functional>
 
@@ -85,7 +86,7 @@ public:
 	}
 
 	// Sets data directly
-	void set(T* data, uint length) {
+	void set(const T* data, uint length) {
 		assert(length <= length && "");
 		alg::copy(data, this->data, length);
 	}
@@ -210,6 +211,21 @@ public:
 		alg::copy(input.data, data + offset, input.length);
 	}
 
+	// Keeps only the first rows of this VMatrix
+	void truncate(uint rows) {
+		assert(rows <= columnLength && "Truncating requires fewer rows");
+
+		columnLength = rows;
+		length = columnLength * rowLength;
+		data = (T*)realloc(data, sizeof(T) * (length ? length : 1));
+	}
+
+	// Swaps row a with row b in place
+	void swapRows(uint a, uint b) {
+		assert(a < columnLength && b < columnLength && "Attempt to swap rows outside of matrix range");
+		std::swap_ranges(data + (size_t)a * rowLength, data + (size_t)(a + 1) * rowLength, data + (size_t)b * rowLength);
+	}
+
 	// Returns a matrix 
 	VMatrix<T> getColumn(uint row) const {
 		VMatrix<T> c(1, this->columnLength, T(0.0));
@@ -459,4 +475,77 @@ static std::ostream& operator<<(std::ostream& os, const VMatrix<T>& m)
 	return os;
 }
 
+/* Read only view of a matrix owned elsewhere
+ * Has the same layout as VMatrix, but never copies or owns data
+ * Owner must outlive the view
+ */
+template <typename T = double>
+class VMatrixView {
+	// Dimensions of viewed data
+	uint rowLength;
+	uint columnLength;
+
+	// Viewed data
+	const T* data;
+
+public:
+	// Creates a view over raw data
+	VMatrixView(const T* data, uint rowLength, uint columnLength)
+		: rowLength(rowLength), columnLength(columnLength), data(data) {
+	}
+
+	// Creates a view over a whole VMatrix
+	VMatrixView(const VMatrix<T>& m)
+		: rowLength(m.getRowLength()), columnLength(m.getColumnLength()), data(m.qGet()) {
+	}
+
+	uint getRowLength() const {
+		return rowLength;
+	}
+
+	uint getColumnLength() const {
+		return columnLength;
+	}
+
+	uint getLength() const {
+		return rowLength * columnLength;
+	}
+
+	// get value by (x,y) coord
+	T get(uint x, uint y) const {
+		assert(x < rowLength && y < columnLength && "Attempt to index outside of matrix range");
+		return data[y * rowLength + x];
+	}
+
+	// gets data directly
+	const T* qGet() const {
+		return data;
+	}
+
+	// Fast get, will return the ith component in 2D internal array
+	T qGet(uint i) const {
+		assert(i < getLength() && "Attempt to qGet outside of possible range");
+		return data[i];
+	}
+
+	// Returns a view of count rows, starting from row start
+	VMatrixView<T> getRows(uint start, uint count) const {
+		assert(start + count <= columnLength && "Attempt to view rows outside of matrix range");
+		return VMatrixView<T>(data + (size_t)start * rowLength, rowLength, count);
+	}
+
+	// Returns a deep copy as a VMatrix
+	VMatrix<T> copy() const {
+		VMatrix<T> c(rowLength, columnLength, T(0));
+		c.set(data, getLength());
+		return c;
+	}
+};
+
+template <typename T>
+static std::ostream& operator<<(std::ostream& os, const VMatrixView<T>& m)
+{
+	return os << m.copy();
+}
+
 #endif
\ No newline at end of file
@@ -0,0 +1,111 @@
+/* Group of threads that run the same job together
+ * Threads are kept for the life of the group, so each run
+ * only costs a wake up rather than creating threads
+ */
+#ifndef __WORKER_GROUP__
+#define __WORKER_GROUP__
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "rand_ex.hpp"
+#include "types.hpp"
+
+class WorkerGroup {
+	// Threads other than the caller
+	std::vector<std::thread> threads;
+
+	std::mutex lock;
+
+	// Signals a new job, or stopping
+	std::condition_variable started;
+
+	// Signals all threads have finished job
+	std::condition_variable finished;
+
+	// Current job, called with index of worker
+	std::function<void(uint)> job;
+
+	// Incremented for each job
+	uint generation = 0;
+
+	// Number of threads yet to finish current job
+	uint remaining = 0;
+
+	bool stopping = false;
+
+	// Loop of each thread, runs each job as index i
+	void work(uint i) {
+		// Stream is fixed by index, so unseeded workers draw the same values every run
+		rand_ex::seed(0, i);
+
+		uint seen = 0;
+		while (true) {
+			std::function<void(uint)>* current;
+			{
+				std::unique_lock<std::mutex> guard(lock);
+				started.wait(guard, [this, seen]() { return stopping || generation != seen; });
+				if (stopping) {
+					return;
+				}
+				seen = generation;
+				current = &job;
+			}
+
+			(*current)(i);
+
+			std::unique_lock<std::mutex> guard(lock);
+			if (!--remaining) {
+				finished.notify_one();
+			}
+		}
+	}
+
+public:
+	// Creates a group of count workers, the caller of run is worker 0
+	WorkerGroup(uint count) {
+		for (uint i = 1; i < count; i++) {
+			threads.push_back(std::thread(&WorkerGroup::work, this, i));
+		}
+	}
+
+	~WorkerGroup() {
+		{
+			std::unique_lock<std::mutex> guard(lock);
+			stopping = true;
+		}
+		started.notify_all();
+		for (auto& thread : threads) {
+			thread.join();
+		}
+	}
+
+	WorkerGroup(const WorkerGroup&) = delete;
+	WorkerGroup& operator=(const WorkerGroup&) = delete;
+
+	// Returns number of workers, including caller
+	uint size() const {
+		return (uint)threads.size() + 1;
+	}
+
+	// Runs f(i) for each worker i, returns once all have finished
+	void run(std::function<void(uint)> f) {
+		{
+			std::unique_lock<std::mutex> guard(lock);
+			job = std::move(f);
+			remaining = (uint)threads.size();
+			generation++;
+		}
+		started.notify_all();
+
+		job(0);
+
+		std::unique_lock<std::mutex> guard(lock);
+		finished.wait(guard, [this]() { return !remaining; });
+	}
+};
+
+#endif
\ No newline at end of file